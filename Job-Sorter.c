@@ -2,25 +2,38 @@
  * * * * * * * * * * * * * * * * * * *
  * Brennan Couturier
  * * * * * * * * * * * * * * * * * * *
- * Compile with gcc -Wall -o Job-Sorter Job-Sorter.c
+ * Compile with gcc -Wall -pthread -o Job-Sorter Job-Sorter.c
  * * * * * * * * * * * * * * * * * * *
  */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <poll.h>
 
 /**
- * This is how much space that is initially given to the input string. If it is too much, we realloc it to a lesser value.
- * If that's not enough space for the line, there's probably a problem with the line, so we exit()
+ * This is how much space that is initially given to the input string. getline() will grow it if a line needs more,
+ *  which can happen now that a line can carry a list of prerequisite jobs.
  */
 #define INITIAL_BUFFER_SIZE 255
 
 /**
- * This determines how many tokens the program looks for in the input line
+ * This determines how many tokens the program requires in every input line
  *  ex. person name, job name, arrival time, duration
+ * Any columns after these are optional and are identified by their name in the header line.
  */
 #define NUM_TOKENS 4
 
@@ -30,780 +43,5231 @@
  */
 #define IDLE_JOB_NAME "IDLE"
 
-//-----------------------JOB INFO-----------------------//
-typedef struct job{
-    char* person_name;
-    char* job_name;
-    size_t arrival_time;
-    size_t duration;
-} job;
+/**
+ * Header name of the optional column listing the jobs that have to finish before a job may start.
+ * The jobs in the column are separated by DEPENDENCY_SEPARATOR, ex. "A;C". NO_DEPENDENCIES means there are none.
+ */
+#define DEPENDS_COLUMN_NAME "Depends"
+#define DEPENDENCY_SEPARATOR ";"
+#define NO_DEPENDENCIES "-"
 
 /**
- * Allocates space for and initializes a job struct
- * Takes the job's data as parameters
- * Returns a pointer to the constructed struct
+ * Header name of the optional column holding the time slot each job has to be finished by.
+ * NO_DEADLINE_ENTRY in the column means the job doesn't have one, which is stored as NO_DEADLINE.
  */
-job* create_job(char* person_name, char* job_name, size_t arrival_time, size_t duration);
+#define DEADLINE_COLUMN_NAME "Deadline"
+#define NO_DEADLINE_ENTRY "-"
+#define NO_DEADLINE SIZE_MAX
 
 /**
- * Checks if a given job is idle by checking its job_name value.
- * Returns 1 if the job is an idle job, 0 otherwise
+ * Arrival times, durations and deadlines can be at most MAX_TIME_SLOT, and there can be at most MAX_CPUS CPUs. EDF
+ *  admission control works with a deadline times the CPU count, and this keeps that well clear of overflowing.
  */
-int is_job_idle(job* j);
+#define MAX_TIME_SLOT ((size_t)1 << 40)
+#define MAX_CPUS ((size_t)1 << 16)
 
 /**
- * Prints out the given job's data in an organized manner.
- * Purely for testing.
+ * The most columns a line can have: the NUM_TOKENS required ones plus every optional one
  */
-void print_job(job* j);
+#define MAX_COLUMNS (NUM_TOKENS + 2)
 
 /**
- * Frees all the memory used by the job
+ * Returned by name_map_get() when a name isn't in the map
  */
-void destroy_job(job* j);
+#define NAME_NOT_FOUND ((size_t)-1)
 
-//-----------------------LINKED LIST INFO-----------------------//
-typedef struct node{
-    job* job;
-    struct node* next;
-} node;
+/**
+ * Marks a free slot in a name map. Also the one offset a string table won't hand out
+ */
+#define NAME_MAP_EMPTY UINT32_MAX
 
 /**
- * Allocates space for and initializes a node struct with the given job
- * Takes a job struct as a parameter
- * Returns a pointer to the allocated node
+ * Fair share weight given to anyone who isn't in the weights file. A person with weight 2 gets twice the CPU time of
+ *  someone with weight 1 when they're both waiting.
  */
-node* create_node(job* j);
+#define DEFAULT_WEIGHT 1
 
 /**
- * Allocates space for and initializes a node struct with an IDLE job
- * Returns a pointer to the allocated node
+ * Virtual time is kept as an integer, with one time slot at weight 1 worth this much. Big enough that weights
+ *  in the thousands still move a person's virtual time along smoothly.
  */
-node* create_idle_node();
+#define VIRTUAL_TIME_SCALE 1048576
 
 /**
- * Prints out the given node's data in a formatted manner. Prints its job's data, as well as the value of n->next
- * Purely for testing
+ * Under fair share, a job keeps the CPU for at least a slice before someone else can take it. Unless --quantum gives
+ *  the length, a slice is the job's own duration split this many ways (at least 1 slot). Without a slice, people
+ *  whose virtual times are level would swap every slot, which costs an event each time. Tying it to the job keeps
+ *  that to a few events per job, while a slice shorter than the job still lets the weights decide who goes. It only
+ *  depends on the job itself, so jobs that haven't arrived yet can't change how earlier ones are scheduled.
  */
-void print_node(node* n);
+#define FAIR_SHARE_SLICES_PER_JOB 8
 
 /**
- * Cycles through a singly linked list referenced by head
- * Returns the number of elements in the list
+ * Trace timestamps are in microseconds. Stretching each time slot to a millisecond keeps the viewer's labels readable.
  */
-size_t get_length_list(node* head);
+#define TRACE_MICROSECONDS_PER_SLOT 1000
 
 /**
- * Cycles through a singly linked list referenced by head, printing out the nodes as it goes
+ * How much trace is kept in memory before it's written out
  */
-void print_full_list(node* head);
+#define TRACE_BUFFER_SIZE 65536
 
 /**
- * Prints output as requested by Assignment 1's instructions
+ * Binary summary files start with SUMMARY_MAGIC and then SUMMARY_VERSION, so anything else is turned away
  */
-void print_output(node* head, node* job_list_head);
+#define SUMMARY_MAGIC "JSSUMMRY"
+#define SUMMARY_VERSION 1
 
 /**
- * Cycles through a singly linked list referenced by head and frees the nodes as it goes
+ * A person's turnaround times are counted in buckets by how many bits they take, so bucket b holds times from
+ *  2^(b-1) up to 2^b - 1 (bucket 0 is a turnaround of 0). Buckets add together when summaries are merged, which
+ *  is what makes the percentiles mergeable.
  */
-void destroy_list(node* head);
+#define SUMMARY_BUCKETS 65
 
 /**
- * Frees a given node from memory. Frees the job first, then itself.
+ * A daemon request starts with a little endian u16 giving the length of the rest of it, then a u8 request type and a
+ *  u32 tag picked by the client. Every request gets back a fixed size response: a u8 status, the request's tag and a
+ *  u64 value, so a client can send lots of requests without waiting and match the answers up afterwards.
  */
-void destroy_node(node* n);
+#define DAEMON_HEADER_SIZE 7
+#define DAEMON_RESPONSE_SIZE 13
+#define DAEMON_SUBMIT_SIZE 26 //arrival, duration and deadline as u64s, then the length of the person's name as a u16
+#define DAEMON_NO_DEADLINE UINT64_MAX
 
 /**
- * Adds a given node to a list, if a node with a job with the same person_name as the passed one is found,
- *  the one with the higher final_index takes the spot. The other is overwritten.
+ * How many ready sockets the daemon takes from epoll at once, and how much it reads from one connection before moving
+ *  on to the next.
  */
-void add_node_to_cultivated_list(node** cultivated_list_head, node** head_ref, node* to_insert);
+#define DAEMON_MAX_EVENTS 256
+#define DAEMON_MAX_READ 1048576
+
 /**
- * Adds a node to the end of a singly linked list referenced by head_ref
- * Returns 0. It really could be a void function...
+ * How many scheduler events the daemon works through before it checks for requests again, so queries it can already
+ *  answer don't wait behind a long reschedule.
  */
-int add_node_to_list_end(node** head_ref, node* to_insert);
+#define DAEMON_SCHEDULE_EVENTS 1024
 
+//-----------------------STRING TABLE INFO-----------------------//
 /**
- * This is the big chungus of functions for this program. It implements the shortest job first algorithm.
- * Given a node with a job of duration n, it first creates n new nodes with increasing arrival_times and decreasing durations
- * It then attempts to add each node individually into the list, based on its arrival_time and duration.
- * The process of adding each node is extensive and complicated, so much that I don't want to describe it here.
- * There are comments throughout the function, though, so it shouldn't be too hard to figure it out.
- * Returns 0, exits if there is a problem. Again, could really be a void function
+ * Every name from the input, back to back in one buffer with a '\0' after each. A name is referred to by the 32-bit
+ *  offset of its first character, which stays the same when the buffer grows (unlike a pointer into it would).
  */
-int add_node_to_list(node** head_ref, node* to_insert);
+typedef struct string_table{
+    char* text;
+    size_t length;
+    size_t capacity;
+} string_table;
 
 /**
- * This adds a node to a special and smaller list of the jobs that came in from stdin.
- * Its purpose is to store the input in a useable way.
- * Returns 0, could be a void function
+ * Allocates space for and initializes an empty string table
+ * Returns a pointer to the table, NULL if it couldn't be allocated
  */
-int add_node_to_job_list(node** head_ref, node* to_insert);
+string_table* create_string_table();
 
 /**
- * Takes in a refernce to the time slices list, reverses it, traverses it looking for first occurance of given job, then reverses it again when done.
- * Returns index of job if found, 0 otherwise
+ * Copies str onto the end of the table
+ * Returns the offset of the copy, exits if there is a problem
  */
-size_t get_last_index_of_job_2(node** head_ref, job* j);
+uint32_t add_string(string_table* strings, char* str);
 
 /**
- * Takes a reversed version of the time slices list and traverses it, looking for the first occurance of the given job
- * If it finds it, returns the index. Otherwise, returns -1
+ * Returns the string at the given offset. Only good until the next add_string(), which may move the text
  */
-size_t get_last_index_of_job(node* head, job* j);
+char* get_string(string_table* strings, uint32_t offset);
 
-//-----------------------FORMATTING-----------------------//
 /**
- * Cycles through the given string and replaces every instance of whitespace with the given replacement character
+ * Frees the table and all its text
  */
-void replace_whitespace(char* line, char replacement_char);
+void destroy_string_table(string_table* strings);
 
-//-----------------------CONVERSIONS-----------------------//
+//-----------------------NAME MAP INFO-----------------------//
 /**
- * Converts a string denoting a number into a size_t variable by turning into an unsigned long long then casting it.
+ * An open addressing hash map from a name to an index. The keys are offsets into a string table rather than copies of
+ *  the names, so a slot is only 8 bytes.
  */
-size_t strtosizet(char* str);
+typedef struct name_map{
+    string_table* strings; //where the keys are, belongs to someone else
+    uint32_t* keys; //NAME_MAP_EMPTY for a free slot
+    uint32_t* values;
+    size_t length;
+    size_t capacity; //always a power of two
+} name_map;
+
+/**
+ * Allocates space for and initializes an empty name map with keys in the given string table
+ * Returns a pointer to the map, NULL if it couldn't be allocated
+ */
+name_map* create_name_map(string_table* strings);
 
-//-----------------------IMPLEMENTATIONS-----------------------//
 /**
- * Calls functions to figure out how a list of jobs should be scheduled according to a shortest job first algorithm.
+ * Looks up the value stored for the given name
+ * Returns the value if found, NAME_NOT_FOUND otherwise
  */
-int main(){
+size_t name_map_get(name_map* map, char* name);
 
-    node* head = NULL; //keeps track of nodes (multiple per job)
+/**
+ * Stores a value for the name at the given offset in the map's string table, unless the name is already in the map.
+ * Returns the value the name maps to afterwards, which is the old one if it was already there. Exits if there is a problem
+ */
+size_t name_map_put(name_map* map, uint32_t name, uint32_t value);
 
-    node* job_list_head = NULL; //keeps track of jobs (only used for output, one node per job)
+/**
+ * Frees the map. The string table belongs to someone else so it's left alone
+ */
+void destroy_name_map(name_map* map);
 
-    //------------------------------//
-    //  Read Input                  //
-    //------------------------------//
+//-----------------------JOB TABLE INFO-----------------------//
+/**
+ * Every job read from stdin, in the order they were read. A job is referred to by its index in this table.
+ * Each field is kept in its own array rather than a struct per job, so the scheduler's loops over arrival times or
+ *  durations read one contiguous run of memory instead of hopping between allocations. Names are stored once in the
+ *  string table and jobs only keep 32-bit ids for them, which comes to 36 bytes per job plus the text of its name.
+ * People get an id in the order they first show up, which is also the order the Summary lists them in.
+ */
+typedef struct job_table{
+    size_t length;
+    size_t capacity;
+    size_t* arrival_times;
+    size_t* durations;
+    size_t* deadlines; //the job should be finished by this time slot, NO_DEADLINE if it doesn't matter
+    uint32_t* person_ids; //the same for every job belonging to a person
+    uint32_t* job_names; //offsets into strings
+    uint32_t* prerequisite_offsets; //job i's prerequisites are prerequisite_names[prerequisite_offsets[i]] up to [i + 1]
+    uint32_t* prerequisite_names; //offsets into strings of the names of the jobs that have to complete first
+    size_t num_prerequisites;
+    size_t prerequisites_capacity;
+    int has_dependencies; //1 if any job lists a prerequisite
+    string_table* strings; //every job, prerequisite and person name
+    name_map* people; //person_name -> person_id
+    uint32_t* person_names; //indexed by person_id, offsets into strings
+    size_t num_people;
+    size_t people_capacity;
+} job_table;
 
-    void* line_v = malloc(INITIAL_BUFFER_SIZE * sizeof(char));
-    if(line_v == NULL){
-        fprintf(stderr, "ERROR in main() : malloc() failed to allocate space for input line\n");
+/**
+ * Allocates space for and initializes an empty job table
+ * Returns a pointer to the table, NULL if it couldn't be allocated
+ */
+job_table* create_job_table();
+
+/**
+ * Adds a job to the end of the table, growing it if needed, and gives the job its person_id. depends is a Depends
+ *  column entry (ex. "A;C"), or NULL if there isn't one
+ * Returns the index of the job, exits if there is a problem
+ */
+size_t add_job_to_table(job_table* table, char* person_name, char* job_name, size_t arrival_time, size_t duration, size_t deadline, char* depends);
+
+/**
+ * Returns the name of the job at job_index
+ */
+char* get_job_name(job_table* table, size_t job_index);
+
+/**
+ * Returns the name of the person with the given id
+ */
+char* get_person_name(job_table* table, size_t person_id);
+
+/**
+ * Reads the header line and then one job per line from the given stream into a new table
+ * Returns the table, exits if the input doesn't make sense
+ */
+job_table* read_jobs(FILE* stream);
+
+/**
+ * Frees the table and every job in it
+ */
+void destroy_job_table(job_table* table);
+
+//-----------------------HEAP INFO-----------------------//
+typedef struct heap_entry{
+    size_t key;
+    size_t index; //a job or a person, depending on what the heap is for
+} heap_entry;
+
+/**
+ * A binary min heap of jobs or people. Entries are ordered by key, then by index so that ties go to whichever job (or
+ *  person) was read first.
+ */
+typedef struct min_heap{
+    heap_entry* entries;
+    size_t length;
+    size_t capacity;
+} min_heap;
+
+/**
+ * Allocates space for and initializes an empty heap
+ * Returns a pointer to the heap, NULL if it couldn't be allocated
+ */
+min_heap* create_min_heap();
+
+/**
+ * Adds an entry to the heap. Exits if there is a problem
+ */
+void min_heap_push(min_heap* heap, size_t key, size_t index);
+
+/**
+ * Removes the smallest entry from the heap
+ * Returns the entry. The heap must not be empty
+ */
+heap_entry min_heap_pop(min_heap* heap);
+
+/**
+ * Frees the heap
+ */
+void destroy_min_heap(min_heap* heap);
+
+//-----------------------SCHEDULE INFO-----------------------//
+/**
+ * One uninterrupted stretch of time a job spent on one CPU, from start up to but not including end
+ */
+typedef struct run{
+    uint32_t job_index;
+    uint32_t cpu;
+    size_t start;
+    size_t end;
+} run;
+
+/**
+ * The result of scheduling a job table. Runs are in the order they started.
+ */
+typedef struct schedule{
+    run* runs;
+    size_t num_runs;
+    size_t capacity;
+    size_t num_cpus;
+    size_t* last_run_on_cpu; //indexed by CPU, index of the latest run on it, or SIZE_MAX if it hasn't had one
+    size_t* completion_times; //indexed by job, the time slot after the job's last one
+    size_t* ready_times; //indexed by job, when it joined the ready queue (or was rejected trying to)
+    char* rejected; //indexed by job, 1 if admission control turned the job away (or one of its prerequisites)
+    size_t num_rejected;
+    size_t makespan; //time the last job finished
+} schedule;
+
+/**
+ * Allocates space for and initializes an empty schedule for num_jobs jobs on num_cpus CPUs
+ * Returns a pointer to the schedule, NULL if it couldn't be allocated
+ */
+schedule* create_schedule(size_t num_jobs, size_t num_cpus);
+
+/**
+ * Makes room for jobs up to num_jobs in a schedule that had room for old_num_jobs. The new jobs start out with
+ *  everything zeroed. Exits if there is a problem
+ */
+void grow_schedule(schedule* s, size_t old_num_jobs, size_t num_jobs);
+
+/**
+ * Records that a job ran on a CPU from start to end. If the job was also the last one to run on that CPU and it ran
+ *  right up until start, the last run is extended instead. Exits if there is a problem
+ */
+void add_run_to_schedule(schedule* s, size_t job_index, size_t cpu, size_t start, size_t end);
+
+/**
+ * Frees the schedule
+ */
+void destroy_schedule(schedule* s);
+
+//-----------------------DEPENDENCY INFO-----------------------//
+/**
+ * The job dependencies as a graph, with an edge from every prerequisite to the job waiting on it.
+ * The edges out of job i are dependents[dependent_offsets[i]] up to dependents[dependent_offsets[i + 1]]
+ */
+typedef struct dependency_graph{
+    size_t* dependent_offsets;
+    size_t* dependents;
+    size_t* num_unmet; //indexed by job, how many of its prerequisites have yet to complete
+} dependency_graph;
+
+/**
+ * Resolves every job's prerequisite names into a dependency graph and makes sure the graph has no cycles.
+ * Returns a pointer to the graph, exits if a prerequisite doesn't exist, is ambiguous, or is part of a cycle
+ */
+dependency_graph* build_dependency_graph(job_table* table);
+
+/**
+ * Uses Kahn's algorithm to check that every job can eventually run. If one can't, walks back through the unfinished
+ *  prerequisites to find and print a cycle. prerequisites holds the job each of the table's prerequisite names
+ *  resolved to, in the same order.
+ * Returns 0 if there are no cycles, -1 otherwise
+ */
+int check_for_cycles(job_table* table, dependency_graph* graph, size_t* prerequisites);
+
+/**
+ * Frees the graph
+ */
+void destroy_dependency_graph(dependency_graph* graph);
+
+//-----------------------ADMISSION INFO-----------------------//
+/**
+ * Marks a missing child in the admission tree
+ */
+#define ADMISSION_NIL SIZE_MAX
+
+typedef struct admission_node{
+    size_t left;
+    size_t right;
+    size_t priority; //treap heap order, bigger is closer to the root
+    size_t deadline;
+    long long work; //time the job still needs
+    long long total_work; //work of everything in this subtree
+    long long worst_lateness; //the most work past its deadline's capacity any job in this subtree would have, running the subtree alone from time 0
+} admission_node;
+
+/**
+ * A treap of the jobs EDF has accepted and not finished, ordered by deadline (then job index).
+ * Running them in deadline order from time t, a job finishes at t plus the work of everything up to and including it.
+ *  Every subtree keeps its total work and the worst lateness within it, so the worst lateness over every job from
+ *  some deadline onwards can be found in one walk down the tree. That makes an admission check O(log n)
+ *  instead of a walk over every accepted job.
+ * A job's node lives at the same index as the job, so no allocation happens after the tree is created, unless
+ *  grow_admission_tree() makes room for more jobs.
+ */
+typedef struct admission_tree{
+    admission_node* nodes;
+    size_t root;
+    size_t num_cpus;
+} admission_tree;
+
+/**
+ * Allocates space for and initializes an empty admission tree for num_jobs jobs sharing num_cpus CPUs.
+ * With one CPU the check is exact. With more it treats the CPUs as one pool of num_cpus slots per time slot, which
+ *  lets through some job sets that can't really be packed, so accepted jobs can still end up late.
+ * Returns a pointer to the tree, NULL if it couldn't be allocated
+ */
+admission_tree* create_admission_tree(size_t num_jobs, size_t num_cpus);
+
+/**
+ * Makes room for jobs up to num_jobs in a tree created for fewer. Exits if there is a problem
+ */
+void grow_admission_tree(admission_tree* tree, size_t num_jobs);
+
+/**
+ * Checks whether a job with the given deadline and work can be added at time without it, or anything already
+ *  accepted, missing its deadline. Adds the job to the tree if so.
+ * Returns 0 if the job was accepted, -1 if it was rejected
+ */
+int admission_tree_admit(admission_tree* tree, size_t job_index, size_t deadline, size_t work, size_t time);
+
+/**
+ * Updates how much work an accepted job has left. A job with no work left is removed from the tree.
+ */
+void admission_tree_set_work(admission_tree* tree, size_t job_index, size_t work);
+
+/**
+ * Frees the tree
+ */
+void destroy_admission_tree(admission_tree* tree);
+
+//-----------------------TRACE INFO-----------------------//
+/**
+ * Writes scheduler events out as Chrome Trace Event JSON, which chrome://tracing and ui.perfetto.dev can open.
+ * Everything goes through a buffer that's only written out when it fills up, so a trace of millions of events costs a
+ *  handful of writes instead of one per event.
+ * Each CPU gets a lane, plus one more lane for things that don't happen on a CPU (arrivals, rejections, the queue).
+ */
+typedef struct trace_writer{
+    FILE* stream;
+    char* path;
+    char* buffer;
+    size_t length;
+    size_t num_events; //everything after the first event needs a comma in front of it
+    size_t jobs_lane; //lane for events that aren't on a CPU, one past the last CPU
+} trace_writer;
+
+/**
+ * Opens path for writing and starts the trace. Exits if there is a problem
+ */
+trace_writer* create_trace_writer(char* path, size_t num_cpus);
+
+/**
+ * Adds an instant event for a job, ex. "Arrived", on the given CPU's lane. cpu can be SIZE_MAX for the jobs lane
+ */
+void trace_job_event(trace_writer* tw, job_table* table, char* name, size_t job_index, size_t cpu, size_t time);
+
+/**
+ * Adds a counter event for how many jobs are waiting in the ready queue and how many are running
+ */
+void trace_queue_depth(trace_writer* tw, size_t time, size_t waiting, size_t running);
+
+/**
+ * Adds a slice for every run in the schedule, on the lane of the CPU it ran on
+ */
+void trace_schedule(trace_writer* tw, schedule* s, job_table* table);
+
+/**
+ * Finishes the trace, writes out whatever is left in the buffer and closes the file. Exits if there is a problem
+ */
+void destroy_trace_writer(trace_writer* tw);
+
+//-----------------------SCHEDULER INFO-----------------------//
+/**
+ * How the scheduler decides who gets the CPU next
+ *  POLICY_SJF          the job with the least time remaining, whoever it belongs to
+ *  POLICY_FAIR_SHARE   the person who has had the least CPU time for their weight, then their job with the least time remaining
+ *  POLICY_EDF          the job with the earliest deadline. Jobs that can't make their deadline are rejected when they're
+ *                      ready, and jobs without one only run when no job with a deadline is waiting
+ *  POLICY_ROUND_ROBIN  the job that has been waiting in line the longest. Goes to the back of the line when its
+ *                      quantum runs out, and keeps its place (and what's left of its quantum) if anything else
+ *                      stops it
+ */
+typedef enum scheduling_policy{
+    POLICY_SJF,
+    POLICY_FAIR_SHARE,
+    POLICY_EDF,
+    POLICY_ROUND_ROBIN
+} scheduling_policy;
+
+/**
+ * Everything that changes how a job table gets scheduled
+ */
+typedef struct scheduler_config{
+    scheduling_policy policy;
+    size_t num_cpus;
+    size_t quantum; //most time slots a job runs before the scheduler takes another look, 0 for no limit. Under
+                    // POLICY_FAIR_SHARE it's the slice length instead, 0 to split each job FAIR_SHARE_SLICES_PER_JOB ways
+    size_t* weights; //indexed by person_id, only used by POLICY_FAIR_SHARE. NULL gives everyone DEFAULT_WEIGHT
+    trace_writer* trace; //gets arrivals, completions, preemptions, rejections and the queue depth. NULL for no trace
+} scheduler_config;
+
+/**
+ * A person's virtual time before it was changed, so a ready queue can be rewound
+ */
+typedef struct virtual_time_change{
+    size_t person;
+    size_t virtual_time;
+} virtual_time_change;
+
+/**
+ * The jobs that are ready to run.
+ * For POLICY_SJF that's a single heap of jobs keyed by time remaining. POLICY_EDF is the same, keyed by deadline, plus
+ *  an admission tree of the accepted jobs that have a deadline. POLICY_ROUND_ROBIN keys it by a ticket that goes up
+ *  every time a job joins the back of the line, which is when it arrives and when it uses up its quantum.
+ * For POLICY_FAIR_SHARE it's two levels: a heap of people keyed by virtual time (CPU time used divided by their weight),
+ *  and inside each person a heap of their jobs keyed by time remaining. Only people with a ready job are in the heap.
+ *  With more than one CPU a person can have jobs running and waiting at once, so rather than dig their old entry out
+ *  of the heap when their virtual time changes, a new one is pushed. The old one is skipped when it comes up. A job
+ *  that an arrival or a completion stopped part way through its slice is held to one side, and goes again first.
+ */
+typedef struct ready_queue{
+    scheduling_policy policy;
+    size_t length; //number of ready jobs
+    size_t num_people;
+    size_t jobs_capacity; //how many jobs the per job arrays have room for
+    size_t people_capacity; //same for the per person arrays
+    min_heap* jobs; //POLICY_SJF and POLICY_EDF
+    admission_tree* admission; //POLICY_EDF
+    min_heap* people; //POLICY_FAIR_SHARE, keyed by virtual time
+    min_heap** person_jobs; //POLICY_FAIR_SHARE, indexed by person_id, created the first time the person has a ready job
+    size_t* virtual_times; //indexed by person_id
+    size_t* virtual_time_per_slot; //indexed by person_id, VIRTUAL_TIME_SCALE / weight
+    char* person_queued; //indexed by person_id, 1 if the person has an up to date entry in the people heap
+    size_t system_virtual_time; //virtual time of the last person picked, which is where newly active people start
+    size_t quantum; //POLICY_FAIR_SHARE's slice length, or POLICY_ROUND_ROBIN's quantum. 0 if none was given
+    min_heap* held; //POLICY_FAIR_SHARE, jobs that were stopped part way through their slice, keyed by job index
+    size_t* slice_left; //POLICY_FAIR_SHARE, indexed by job, how much of its slice it has left
+    size_t next_ticket; //POLICY_ROUND_ROBIN
+    size_t* tickets; //POLICY_ROUND_ROBIN, indexed by job, its place in line
+    size_t* slots_used; //POLICY_ROUND_ROBIN, indexed by job, how much of its quantum it has used
+    int keeping_changes; //1 if every virtual time change goes in changes, so the queue can be rewound
+    virtual_time_change* changes; //POLICY_FAIR_SHARE, oldest first
+    size_t num_changes;
+    size_t changes_capacity;
+} ready_queue;
+
+/**
+ * Allocates space for and initializes an empty ready queue for the given table
+ * Returns a pointer to the queue, exits if there is a problem
+ */
+ready_queue* create_ready_queue(job_table* table, scheduler_config* config);
+
+/**
+ * Adds a job that has just become ready to run at time, with remaining time left on it. Exits if there is a problem
+ * Returns 0 if the job was added, -1 if admission control rejected it
+ */
+int ready_queue_push(ready_queue* q, job_table* table, size_t job_index, size_t remaining, size_t time);
+
+/**
+ * Removes the next job to run from the queue. The job should run for at most max_slots before ready_queue_return()
+ *  is called for it. max_slots is SIZE_MAX if the policy doesn't care how long it runs.
+ * Returns the job's index. The queue must not be empty
+ */
+size_t ready_queue_pop(ready_queue* q, job_table* table, size_t* max_slots);
+
+/**
+ * Tells the queue the job it last gave out ran for ran_for slots and has remaining left. Puts it back if it isn't done.
+ */
+void ready_queue_return(ready_queue* q, job_table* table, size_t job_index, size_t ran_for, size_t remaining);
+
+/**
+ * Makes room for jobs (and people) added to the table since the queue was created. New people get DEFAULT_WEIGHT.
+ *  Exits if there is a problem
+ */
+void ready_queue_add_jobs(ready_queue* q, job_table* table);
+
+/**
+ * Empties the queue and puts it back how it was when it was last empty, at a point where it had handed out
+ *  next_ticket tickets, its system virtual time was system_virtual_time and it had made num_changes virtual time
+ *  changes. Only works if it has been keeping its changes.
+ */
+void ready_queue_rewind(ready_queue* q, size_t next_ticket, size_t system_virtual_time, size_t num_changes);
+
+/**
+ * Frees the queue
+ */
+void destroy_ready_queue(ready_queue* q);
+
+/**
+ * Used to sort jobs by arrival. Jobs that arrive together stay in the order they were read.
+ */
+typedef struct arrival{
+    size_t time;
+    size_t job_index;
+} arrival;
+
+/**
+ * A point a resumable scheduler can go back to: the top of its loop at a time when nothing was ready or running,
+ *  before that time's arrivals joined. Every job that arrived earlier was done with by then, so this and the jobs
+ *  that hadn't arrived yet are all it takes to put the scheduler back how it was.
+ */
+typedef struct scheduler_checkpoint{
+    size_t time;
+    size_t next_arrival;
+    size_t num_completed;
+    size_t num_runs;
+    size_t num_rejected;
+    size_t makespan;
+    size_t next_ticket; //the ready queue's
+    size_t system_virtual_time; //the ready queue's
+    size_t num_changes; //how many virtual time changes the ready queue had made
+} scheduler_checkpoint;
+
+/**
+ * Everything schedule_jobs() keeps while it works from event to event, so it can stop part way and carry on later.
+ * A resumable one can also be given more jobs, even after it has finished. A job arriving at or after the time it
+ *  has got up to just joins the arrivals. One arriving earlier sends it back to the last checkpoint before the job
+ *  arrived, and it works forward from there again, which only costs the rest of the busy period the job lands in
+ *  (and everything after it).
+ * Its schedule's completion time for a job is SIZE_MAX until the job has been worked out.
+ */
+typedef struct scheduler{
+    job_table* table;
+    dependency_graph* graph; //NULL if no job has prerequisites
+    scheduler_config* config;
+    schedule* s;
+    ready_queue* ready;
+    size_t num_jobs; //how many of the table's jobs it has
+    size_t jobs_capacity; //how many jobs the per job arrays have room for
+    size_t* remaining; //indexed by job, time left on it
+    size_t* unmet; //indexed by job, prerequisites it's still waiting on
+    char* arrived; //indexed by job
+    arrival* arrivals; //every job, sorted by arrival
+    size_t* reject_stack;
+    size_t* last_cpu; //indexed by job, the CPU it last ran on
+    size_t* picked; //jobs running until the next event
+    size_t* picked_cpu;
+    char* cpu_taken;
+    size_t time;
+    size_t next_arrival; //arrivals[next_arrival] is the next job to show up
+    size_t num_completed; //jobs that finished or were rejected
+    size_t arrivals_through; //the last time the loop let arrivals join the ready queue
+    //Only needed to spot preemptions for the trace. A job that was running up until now, isn't finished and wasn't
+    // picked again has been preempted
+    size_t* picked_at; //indexed by job, the last time it was picked
+    size_t* prev_picked; //the jobs that were running up until now
+    size_t num_prev_picked;
+    size_t last_waiting;
+    size_t last_running;
+    int resumable;
+    scheduler_checkpoint* checkpoints; //oldest first
+    size_t num_checkpoints;
+    size_t checkpoints_capacity;
+    size_t rewind_to; //the earliest arrival it has to go back for before carrying on, SIZE_MAX if none
+} scheduler;
+
+/**
+ * Allocates space for and initializes a scheduler for the jobs in table. A resumable one keeps checkpoints so it can
+ *  be given more jobs later, which needs graph to be NULL and config to have no weights or trace.
+ * Returns a pointer to the scheduler, exits if there is a problem
+ */
+scheduler* create_scheduler(job_table* table, dependency_graph* graph, scheduler_config* config, int resumable);
+
+/**
+ * Works through at most max_events events.
+ * Returns 1 if every job it has is done with, 0 if there's more to do
+ */
+int run_scheduler(scheduler* sch, size_t max_events);
+
+/**
+ * Gives a resumable scheduler the jobs added to its table since it was created or last given any. It goes back as
+ *  far as it needs to the next time it runs. Exits if there is a problem
+ */
+void scheduler_add_jobs(scheduler* sch);
+
+/**
+ * Frees the scheduler
+ * Returns the schedule it worked out, which now belongs to the caller
+ */
+schedule* finish_scheduler(scheduler* sch);
+
+/**
+ * This is the big chungus of functions for this program. With POLICY_SJF it implements the shortest job first
+ *  algorithm, where a job with less time remaining than the running one takes over the CPU.
+ * It jumps from event to event (an arrival, a completion, the end of a fair share slice or a quantum) instead of stepping
+ *  through every time slot. At each event the running jobs go back in the ready queue and the best num_cpus come out,
+ *  staying on the same CPU if they were already running. A job only joins the ready queue once it has arrived and every
+ *  one of its prerequisites has completed.
+ * The config, table and graph are only read, so several schedules can be worked out at once from the same input.
+ * Each job is pushed onto the ready queue once on arrival, once per preemption and once per dependency release.
+ *  With POLICY_SJF and POLICY_EDF preemptions only happen at arrivals and completions, so that's O((V + E) log V) for
+ *  V jobs and E dependencies. POLICY_FAIR_SHARE and POLICY_ROUND_ROBIN with a quantum also preempt every time a slice
+ *  or quantum runs out, which adds O((W / q) log V) for W time slots of work and a slice or quantum of q. Fair share's
+ *  own slices split each job at most FAIR_SHARE_SLICES_PER_JOB ways, which makes that O(V log V).
+ * Returns the schedule, exits if there is a problem
+ */
+schedule* schedule_jobs(job_table* table, dependency_graph* graph, scheduler_config* config);
+
+//-----------------------OPTIONS INFO-----------------------//
+/**
+ * What the command line asked for. Without --sweep each list has exactly one entry. With it, every combination of
+ *  policy, CPU count and quantum gets scheduled
+ */
+typedef struct options{
+    scheduling_policy* policies;
+    size_t num_policies;
+    size_t* cpu_counts;
+    size_t num_cpu_counts;
+    size_t* quanta;
+    size_t num_quanta;
+    char* weights_path; //NULL if no weights file was given
+    char* trace_path; //NULL if no trace was asked for
+    int sweep; //1 if --sweep was given
+    size_t num_threads; //how many configs a sweep runs or summary files are merged at once, 0 for one per online core
+    char* summary_path; //where to write a binary summary, NULL for nowhere
+    char** merge_paths; //with --merge-summaries, the summary files to merge. Points into argv
+    size_t num_merge_paths;
+    int merge; //1 if --merge-summaries was given
+    char* serve_path; //with --serve, the socket to listen on. NULL otherwise
+    char* client_path; //with --client, the socket of the daemon to send requests to. NULL otherwise
+} options;
+
+/**
+ * Reads the command line into opts. Prints the usage and exits if something doesn't make sense
+ */
+void parse_options(int argc, char** argv, options* opts);
+
+/**
+ * Frees the lists in opts
+ */
+void destroy_options(options* opts);
+
+/**
+ * Works out how many threads to use for num_tasks things that can run at once: what was asked for, or one per
+ *  online core if nothing was, but never more than there are tasks
+ */
+size_t count_threads(options* opts, size_t num_tasks);
+
+/**
+ * Prints how to run the program to the given stream
+ */
+void print_usage(FILE* stream, char* program_name);
+
+/**
+ * Reads a weights file, one "person weight" pair per line. People who aren't in the file get DEFAULT_WEIGHT,
+ *  people in the file who don't have any jobs are ignored.
+ * Returns an array of weights indexed by person_id, exits if there is a problem
+ */
+size_t* read_weights(char* path, job_table* table);
+
+//-----------------------SWEEP INFO-----------------------//
+/**
+ * The numbers a sweep compares configs by, worked out from a schedule so the schedule itself can be freed straight away
+ */
+typedef struct sweep_result{
+    size_t* latest_completion; //indexed by person_id, SIZE_MAX if none of their jobs finished
+    size_t makespan;
+    double mean_turnaround; //completion - arrival, over the jobs that finished
+    double mean_wait; //turnaround - duration, over the jobs that finished
+    size_t num_late;
+    size_t num_rejected;
+} sweep_result;
+
+/**
+ * Shared between the sweep's worker threads. The table, graph and configs are only ever read. A worker takes the
+ *  next config by bumping next_config under the lock, and is the only one to write that config's result.
+ */
+typedef struct sweep{
+    job_table* table;
+    dependency_graph* graph;
+    scheduler_config* configs;
+    sweep_result* results; //indexed the same as configs
+    size_t num_configs;
+    size_t next_config;
+    pthread_mutex_t lock;
+} sweep;
+
+/**
+ * Schedules the table under every combination of the policies, CPU counts and quanta in opts, spread over a pool of
+ *  threads, then prints a table comparing them. Exits if there is a problem
+ */
+void run_sweep(job_table* table, dependency_graph* graph, size_t* weights, options* opts);
+
+/**
+ * Works out the numbers a sweep compares from a finished schedule
+ */
+void summarize_schedule(schedule* s, job_table* table, sweep_result* result);
+
+/**
+ * Prints the aggregate numbers for each config, then each person's completion time under each config
+ */
+void print_sweep(sweep* sw);
+
+//-----------------------SUMMARY INFO-----------------------//
+/**
+ * Everything the Summary says about one person, kept in a form where two of them can be added together. That way a
+ *  trace can be split into shards, each shard scheduled on its own, and the shards' summaries merged afterwards.
+ */
+typedef struct person_summary{
+    uint64_t latest_completion; //UINT64_MAX if none of their jobs finished
+    uint64_t num_jobs;
+    uint64_t num_completed;
+    uint64_t num_late;
+    uint64_t num_rejected;
+    uint64_t turnaround_total; //over the jobs that finished
+    uint64_t turnaround_max;
+    uint64_t turnaround_buckets[SUMMARY_BUCKETS];
+    uint64_t first_seen; //where the person first showed up, (file << 32) | position. The merged Summary is in this order
+} person_summary;
+
+/**
+ * A summary for every person, in the order they first showed up
+ */
+typedef struct summary{
+    person_summary* people;
+    uint32_t* names; //indexed the same as people, offsets into strings
+    size_t num_people;
+    size_t capacity;
+    string_table* strings;
+    name_map* ids; //name -> index into people
+    size_t* partition_offsets; //set by the merge, the people in partition p are partition_order[offsets[p]] up to [p + 1]
+    uint32_t* partition_order;
+} summary;
+
+/**
+ * Allocates space for and initializes an empty summary. Exits if there is a problem
+ */
+summary* create_summary();
+
+/**
+ * Finds a person in the summary, adding them with nothing recorded yet if they aren't in it
+ * Returns their index in the summary
+ */
+size_t summary_find_person(summary* sum, char* name);
+
+/**
+ * Builds the summary of a finished schedule
+ */
+summary* summarize_people(schedule* s, job_table* table);
+
+/**
+ * Adds everything recorded in from onto into. Completion times take the latest, counts and buckets add up
+ */
+void merge_person_summary(person_summary* into, person_summary* from);
+
+/**
+ * Writes the summary to path in the binary summary format. Exits if there is a problem
+ */
+void write_summary(summary* sum, char* path);
+
+/**
+ * Reads a summary written by write_summary(). Exits if the file can't be read or isn't a summary
+ */
+summary* read_summary(char* path);
+
+/**
+ * Merges the summary files in opts. Every file is read on its own thread, and each file's people are split into one
+ *  partition per thread (but no more partitions than people or cores) by a hash of their name. Then each thread merges one
+ *  partition from every file, so no two threads ever touch the same person.
+ * Returns the merged summary, exits if there is a problem
+ */
+summary* merge_summaries(options* opts);
+
+/**
+ * Prints a summary table with each person's latest completion, job counts and turnaround times
+ */
+void print_summary(summary* sum);
+
+/**
+ * Frees the summary
+ */
+void destroy_summary(summary* sum);
+
+//-----------------------DAEMON INFO-----------------------//
+typedef enum daemon_request_type{
+    REQUEST_SUBMIT = 1, //add a job. The value in the response is the job's index
+    REQUEST_JOB = 2, //when the named job completes
+    REQUEST_PERSON = 3 //when the named person's last job completes, like the Summary
+} daemon_request_type;
+
+typedef enum daemon_status{
+    STATUS_OK = 0,
+    STATUS_NOT_FOUND = 1, //no job or person by that name
+    STATUS_REJECTED = 2, //admission control turned the job away, or all of the person's jobs
+    STATUS_DUPLICATE = 3, //a job by that name was already submitted
+    STATUS_BAD_REQUEST = 4, //the request didn't make sense
+    STATUS_FULL = 5 //the daemon can't hold any more jobs
+} daemon_status;
+
+/**
+ * A client of the daemon. Requests are read into in until a whole one has arrived, responses wait in out until the
+ *  socket has room for them.
+ */
+typedef struct daemon_connection{
+    int fd;
+    unsigned char* in;
+    size_t in_length;
+    size_t in_capacity;
+    unsigned char* out;
+    size_t out_sent; //out[out_sent] up to [out_length] hasn't been sent yet
+    size_t out_length;
+    size_t out_capacity;
+    uint32_t events; //what epoll is watching the socket for
+    int closing; //1 once the client has stopped sending. It's closed when everything owed to it has been sent
+    size_t waiting_for; //0, or how many jobs the scheduler needs before the first request left in in can be answered
+    int batched; //1 while it's in the daemon's batch
+    size_t index; //where it is in the daemon's list of connections
+} daemon_connection;
+
+/**
+ * Everything the daemon keeps between requests. Submitted jobs go straight into the table, and the scheduler is only
+ *  given them when a query comes in that can't be answered without them. The scheduler keeps its state between
+ *  queries, so it only works out what the new jobs change.
+ */
+typedef struct scheduler_daemon{
+    char* socket_path;
+    int listen_fd;
+    int epoll_fd;
+    job_table* table;
+    name_map* jobs; //job name -> job index
+    size_t* last_job; //indexed by person_id, the index of their newest job
+    size_t* previous_job; //indexed by job, the index of the same person's job before it, SIZE_MAX if there isn't one
+    size_t people_capacity;
+    size_t jobs_capacity; //how many jobs previous_job has room for
+    scheduler_config config;
+    scheduler* sch; //resumable, has the first sch->num_jobs jobs in the table
+    int scheduled; //1 once sch has worked out every job it has
+    size_t stale_from; //the earliest arrival time of the jobs sch doesn't have, SIZE_MAX if it has them all
+    daemon_connection** connections;
+    size_t num_connections;
+    size_t connections_capacity;
+    size_t num_waiting; //connections with waiting_for set
+    daemon_connection** batch; //connections that had something to read this time round
+    size_t num_batched;
+    char* names; //room to copy two names out of a request and end them with a '\0'
+} scheduler_daemon;
+
+/**
+ * Listens on opts->serve_path for job submissions and completion queries until SIGINT or SIGTERM, scheduling with
+ *  opts' policy, CPU count and quantum. Starts with no jobs.
+ * Exits if there is a problem setting up the socket
+ */
+void run_daemon(options* opts);
+
+/**
+ * A small client for trying the daemon out. Reads one request per line from stream:
+ *  submit PERSON JOB ARRIVAL DURATION [DEADLINE]
+ *  job JOB
+ *  person PERSON
+ * sends them all to the daemon listening at socket_path without waiting in between, then prints each line with its answer
+ */
+void run_client(char* socket_path, FILE* stream);
+
+//-----------------------OUTPUT INFO-----------------------//
+/**
+ * Prints output as requested by Assignment 1's instructions
+ * With more than one CPU the time slots get a column per CPU instead of a single Job column.
+ * With POLICY_FAIR_SHARE the Summary also shows how much of the CPU time used while each person had work to do went to
+ *  them, next to what their weight entitled them to over the same time.
+ * Jobs that finished after their deadline, or were rejected by admission control, are listed next to their person.
+ */
+void print_output(schedule* s, job_table* table, scheduler_config* config);
+
+//-----------------------FORMATTING-----------------------//
+/**
+ * Cycles through the given string and replaces every instance of whitespace with the given replacement character
+ */
+void replace_whitespace(char* line, char replacement_char);
+
+/**
+ * Splits a line of input into its comma separated tokens. At most max_tokens are stored in tokens.
+ * Returns how many tokens the line has, which may be more than max_tokens
+ */
+size_t tokenize_line(char* line, char** tokens, size_t max_tokens);
+
+//-----------------------CONVERSIONS-----------------------//
+/**
+ * Converts a string denoting a number into a size_t variable by turning into an unsigned long long then casting it.
+ */
+size_t strtosizet(char* str);
+
+//-----------------------IMPLEMENTATIONS-----------------------//
+/**
+ * Calls functions to figure out how a list of jobs should be scheduled according to a shortest job first algorithm,
+ *  or a fair share between people if asked for on the command line.
+ */
+int main(int argc, char** argv){
+
+    options opts;
+    parse_options(argc, argv, &opts);
+
+    //The daemon and its client take their jobs from the socket, and merging summaries doesn't schedule anything, so
+    // none of them read the usual input
+    if(opts.serve_path != NULL){
+        run_daemon(&opts);
+        destroy_options(&opts);
+        return 0;
+    }
+    if(opts.client_path != NULL){
+        run_client(opts.client_path, stdin);
+        destroy_options(&opts);
+        return 0;
+    }
+    if(opts.merge){
+        summary* merged = merge_summaries(&opts);
+        print_summary(merged);
+        if(opts.summary_path != NULL){
+            write_summary(merged, opts.summary_path);
+        }
+        destroy_summary(merged);
+        destroy_options(&opts);
+        return 0;
+    }
+
+    //------------------------------//
+    //  Read Input                  //
+    //------------------------------//
+
+    //The input is only read once, even when sweeping over lots of configs. Nothing changes it after this
+    job_table* table = read_jobs(stdin);
+    dependency_graph* graph = build_dependency_graph(table);
+    size_t* weights = NULL;
+    if(opts.weights_path != NULL){
+        weights = read_weights(opts.weights_path, table);
+    }
+
+    if(opts.sweep){
+        run_sweep(table, graph, weights, &opts);
+    }else{
+        scheduler_config config;
+        config.policy = opts.policies[0];
+        config.num_cpus = opts.cpu_counts[0];
+        config.quantum = opts.quanta[0];
+        config.weights = weights;
+        config.trace = NULL;
+        if(opts.trace_path != NULL){
+            config.trace = create_trace_writer(opts.trace_path, config.num_cpus);
+        }
+
+        //At this point we know every job can eventually run, so schedule them!
+        schedule* s = schedule_jobs(table, graph, &config);
+
+        if(config.trace != NULL){
+            trace_schedule(config.trace, s, table);
+            destroy_trace_writer(config.trace);
+        }
+
+        print_output(s, table, &config);
+
+        if(opts.summary_path != NULL){
+            summary* sum = summarize_people(s, table);
+            write_summary(sum, opts.summary_path);
+            destroy_summary(sum);
+        }
+
+        destroy_schedule(s);
+    }
+
+    free(weights);
+    destroy_options(&opts);
+    destroy_dependency_graph(graph);
+    destroy_job_table(table);
+
+    return 0;
+}
+
+//-----------------------STRING TABLE IMPLEMENTATIONS-----------------------//
+
+string_table* create_string_table(){
+    void* to_return_v = malloc(sizeof(string_table));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_string_table() : Could not allocate space for string table struct\n");
+        return NULL;
+    }
+    string_table* to_return = (string_table*)to_return_v;
+    to_return->length = 0;
+    to_return->capacity = INITIAL_BUFFER_SIZE;
+    to_return->text = (char*)malloc(to_return->capacity * sizeof(char));
+    if(to_return->text == NULL){
+        fprintf(stderr, "ERROR in create_string_table() : Could not allocate space for text\n");
+        free(to_return);
+        return NULL;
+    }
+
+    return to_return;
+}
+
+uint32_t add_string(string_table* strings, char* str){
+    size_t size = strlen(str) + 1;
+    if(strings->length + size > NAME_MAP_EMPTY){
+        fprintf(stderr, "ERROR in add_string() : Names add up to more than %u characters\n", NAME_MAP_EMPTY);
+        exit(EXIT_FAILURE);
+    }
+    if(strings->length + size > strings->capacity){
+        size_t new_capacity = strings->capacity * 2;
+        while(strings->length + size > new_capacity){
+            new_capacity *= 2;
+        }
+        void* text_v = realloc(strings->text, new_capacity * sizeof(char));
+        if(text_v == NULL){
+            fprintf(stderr, "ERROR in add_string() : Could not grow string table\n");
+            exit(EXIT_FAILURE);
+        }
+        strings->text = (char*)text_v;
+        strings->capacity = new_capacity;
+    }
+
+    uint32_t offset = (uint32_t)strings->length;
+    memcpy(strings->text + offset, str, size);
+    strings->length += size;
+    return offset;
+}
+
+char* get_string(string_table* strings, uint32_t offset){
+    return strings->text + offset;
+}
+
+void destroy_string_table(string_table* strings){
+    free(strings->text);
+    free(strings);
+}
+
+//-----------------------JOB TABLE IMPLEMENTATIONS-----------------------//
+
+job_table* create_job_table(){
+    void* to_return_v = malloc(sizeof(job_table));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_job_table() : Could not allocate space for job table struct\n");
+        return NULL;
+    }
+    job_table* to_return = (job_table*)to_return_v;
+    to_return->length = 0;
+    to_return->capacity = 0;
+    to_return->arrival_times = NULL;
+    to_return->durations = NULL;
+    to_return->deadlines = NULL;
+    to_return->person_ids = NULL;
+    to_return->job_names = NULL;
+    to_return->prerequisite_names = NULL;
+    to_return->num_prerequisites = 0;
+    to_return->prerequisites_capacity = 0;
+    to_return->has_dependencies = 0;
+    to_return->person_names = NULL;
+    to_return->num_people = 0;
+    to_return->people_capacity = 0;
+
+    //There's always one more prerequisite offset than there are jobs, so it starts out with the first one
+    to_return->prerequisite_offsets = (uint32_t*)calloc(1, sizeof(uint32_t));
+    to_return->strings = create_string_table();
+    to_return->people = to_return->strings == NULL ? NULL : create_name_map(to_return->strings);
+    if(to_return->prerequisite_offsets == NULL || to_return->people == NULL){
+        fprintf(stderr, "ERROR in create_job_table() : Could not allocate space for people map\n");
+        if(to_return->strings != NULL){
+            destroy_string_table(to_return->strings);
+        }
+        free(to_return->prerequisite_offsets);
+        free(to_return);
+        return NULL;
+    }
+
+    return to_return;
+}
+
+/**
+ * Grows one of the table's per job arrays to new_capacity elements of the given size
+ */
+static void* grow_job_array(void* array, size_t new_capacity, size_t element_size){
+    void* array_v = realloc(array, new_capacity * element_size);
+    if(array_v == NULL){
+        fprintf(stderr, "ERROR in grow_job_array() : Could not grow job table\n");
+        exit(EXIT_FAILURE);
+    }
+    return array_v;
+}
+
+/**
+ * Splits a Depends column entry (ex. "A;C") and adds each name onto the end of the table's prerequisite list
+ */
+static void add_prerequisites(job_table* table, char* depends){
+    char* rest = NULL;
+    char* token = strtok_r(depends, DEPENDENCY_SEPARATOR, &rest);
+    while(token != NULL){
+        if(table->num_prerequisites == table->prerequisites_capacity){
+            if(table->num_prerequisites == NAME_MAP_EMPTY){
+                fprintf(stderr, "ERROR in add_prerequisites() : More than %u prerequisites\n", NAME_MAP_EMPTY);
+                exit(EXIT_FAILURE);
+            }
+            size_t new_capacity = table->prerequisites_capacity == 0 ? 16 : table->prerequisites_capacity * 2;
+            table->prerequisite_names = (uint32_t*)grow_job_array(table->prerequisite_names, new_capacity, sizeof(uint32_t));
+            table->prerequisites_capacity = new_capacity;
+        }
+        table->prerequisite_names[table->num_prerequisites] = add_string(table->strings, token);
+        table->num_prerequisites++;
+        token = strtok_r(NULL, DEPENDENCY_SEPARATOR, &rest);
+    }
+}
+
+size_t add_job_to_table(job_table* table, char* person_name, char* job_name, size_t arrival_time, size_t duration, size_t deadline, char* depends){
+    if(table->length == table->capacity){
+        //Job indexes have to fit in 32 bits
+        if(table->length == NAME_MAP_EMPTY){
+            fprintf(stderr, "ERROR in add_job_to_table() : More than %u jobs\n", NAME_MAP_EMPTY);
+            exit(EXIT_FAILURE);
+        }
+        //Double the space every time we run out so adding n jobs is O(n) overall
+        size_t new_capacity = table->capacity == 0 ? 16 : table->capacity * 2;
+        table->arrival_times = (size_t*)grow_job_array(table->arrival_times, new_capacity, sizeof(size_t));
+        table->durations = (size_t*)grow_job_array(table->durations, new_capacity, sizeof(size_t));
+        table->deadlines = (size_t*)grow_job_array(table->deadlines, new_capacity, sizeof(size_t));
+        table->person_ids = (uint32_t*)grow_job_array(table->person_ids, new_capacity, sizeof(uint32_t));
+        table->job_names = (uint32_t*)grow_job_array(table->job_names, new_capacity, sizeof(uint32_t));
+        table->prerequisite_offsets = (uint32_t*)grow_job_array(table->prerequisite_offsets, new_capacity + 1, sizeof(uint32_t));
+        table->capacity = new_capacity;
+    }
+
+    //Give the job's person an id if this is the first we've seen of them
+    size_t person_id = name_map_get(table->people, person_name);
+    if(person_id == NAME_NOT_FOUND){
+        if(table->num_people == table->people_capacity){
+            size_t new_capacity = table->people_capacity == 0 ? 16 : table->people_capacity * 2;
+            void* names_v = realloc(table->person_names, new_capacity * sizeof(uint32_t));
+            if(names_v == NULL){
+                fprintf(stderr, "ERROR in add_job_to_table() : Could not grow person name list\n");
+                exit(EXIT_FAILURE);
+            }
+            table->person_names = (uint32_t*)names_v;
+            table->people_capacity = new_capacity;
+        }
+        person_id = table->num_people;
+        table->person_names[person_id] = add_string(table->strings, person_name);
+        name_map_put(table->people, table->person_names[person_id], (uint32_t)person_id);
+        table->num_people++;
+    }
+
+    size_t i = table->length;
+    table->arrival_times[i] = arrival_time;
+    table->durations[i] = duration;
+    table->deadlines[i] = deadline;
+    table->person_ids[i] = (uint32_t)person_id;
+    table->job_names[i] = add_string(table->strings, job_name);
+    if(depends != NULL && strcmp(depends, NO_DEPENDENCIES) != 0){
+        add_prerequisites(table, depends);
+    }
+    table->prerequisite_offsets[i + 1] = (uint32_t)table->num_prerequisites;
+    if(table->prerequisite_offsets[i + 1] > table->prerequisite_offsets[i]){
+        table->has_dependencies = 1;
+    }
+
+    table->length++;
+    return i;
+}
+
+char* get_job_name(job_table* table, size_t job_index){
+    return get_string(table->strings, table->job_names[job_index]);
+}
+
+char* get_person_name(job_table* table, size_t person_id){
+    return get_string(table->strings, table->person_names[person_id]);
+}
+
+job_table* read_jobs(FILE* stream){
+    job_table* table = create_job_table(); //keeps track of jobs, one entry per line of input
+    if(table == NULL){
+        fprintf(stderr, "ERROR in read_jobs() : Could not allocate space for job table\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t line_size = INITIAL_BUFFER_SIZE;
+    void* line_v = malloc(line_size * sizeof(char));
+    if(line_v == NULL){
+        fprintf(stderr, "ERROR in read_jobs() : malloc() failed to allocate space for input line\n");
+        exit(EXIT_FAILURE);
+    }
+    char* line = (char*)line_v;
+
+    //The first line is the header. The first NUM_TOKENS columns are always there, the rest are found by name
+    size_t depends_column = 0; //0 means there isn't one, since column 0 is always the person's name
+    size_t deadline_column = 0;
+    size_t num_columns = NUM_TOKENS;
+    if(getline(&line, &line_size, stream) != -1){
+        replace_whitespace(line, ',');
+        char* header_tokens[MAX_COLUMNS];
+        size_t num_header_tokens = tokenize_line(line, header_tokens, MAX_COLUMNS);
+        if(num_header_tokens > MAX_COLUMNS){
+            fprintf(stderr, "ERROR in read_jobs() : Too many columns in header : The optional columns are \"%s\" and \"%s\"\n", DEPENDS_COLUMN_NAME, DEADLINE_COLUMN_NAME);
+            exit(EXIT_FAILURE);
+        }
+        size_t i;
+        for(i = NUM_TOKENS; i < num_header_tokens; i++){
+            if(depends_column == 0 && strcasecmp(header_tokens[i], DEPENDS_COLUMN_NAME) == 0){
+                depends_column = i;
+            }else if(deadline_column == 0 && strcasecmp(header_tokens[i], DEADLINE_COLUMN_NAME) == 0){
+                deadline_column = i;
+            }else{
+                fprintf(stderr, "ERROR in read_jobs() : Unrecognised column %s in header : The optional columns are \"%s\" and \"%s\"\n", header_tokens[i], DEPENDS_COLUMN_NAME, DEADLINE_COLUMN_NAME);
+                exit(EXIT_FAILURE);
+            }
+        }
+        if(num_header_tokens > num_columns){
+            num_columns = num_header_tokens;
+        }
+    }
+
+    while(getline(&line, &line_size, stream) != -1){
+        //We have a line of input, we need to get rid of whitespace.
+        replace_whitespace(line, ',');
+
+        //Now that each line is in csv format, we can tokenize it
+        char* tokens[MAX_COLUMNS];
+        size_t num_line_tokens = tokenize_line(line, tokens, num_columns);
+        if(num_line_tokens == 0){
+            //Blank line, nothing to schedule
+            continue;
+        }
+        if(num_line_tokens < NUM_TOKENS || num_line_tokens > num_columns){
+            fprintf(stderr, "ERROR in read_jobs() : Expected between %d and %zu columns, found %zu : Are you sure you are inputting the right data?\n", NUM_TOKENS, num_columns, num_line_tokens);
+            exit(EXIT_FAILURE);
+        }
+
+        //Now we have an array with all the information we need to add a job
+        char* person_name = tokens[0];
+        char* job_name = tokens[1];
+        size_t arrival_time = strtosizet(tokens[2]);
+        size_t duration = strtosizet(tokens[3]);
+
+        size_t deadline = NO_DEADLINE;
+        if(deadline_column != 0 && num_line_tokens > deadline_column && strcmp(tokens[deadline_column], NO_DEADLINE_ENTRY) != 0){
+            deadline = strtosizet(tokens[deadline_column]);
+        }
+
+        if(arrival_time > MAX_TIME_SLOT || duration > MAX_TIME_SLOT || (deadline != NO_DEADLINE && deadline > MAX_TIME_SLOT)){
+            fprintf(stderr, "ERROR in read_jobs() : Job %s has a time past the last time slot, %zu\n", job_name, MAX_TIME_SLOT);
+            exit(EXIT_FAILURE);
+        }
+
+        char* depends = NULL;
+        if(depends_column != 0 && num_line_tokens > depends_column){
+            depends = tokens[depends_column];
+        }
+
+        add_job_to_table(table, person_name, job_name, arrival_time, duration, deadline, depends);
+    }
+    free(line);
+
+    return table;
+}
+
+void destroy_job_table(job_table* table){
+    destroy_name_map(table->people);
+    destroy_string_table(table->strings);
+    free(table->person_names);
+    free(table->prerequisite_names);
+    free(table->prerequisite_offsets);
+    free(table->job_names);
+    free(table->person_ids);
+    free(table->deadlines);
+    free(table->durations);
+    free(table->arrival_times);
+    free(table);
+}
+
+//-----------------------NAME MAP IMPLEMENTATIONS-----------------------//
+
+/**
+ * FNV-1a, it's short and spreads short names like "A" and "B" out well enough
+ */
+static size_t hash_name(char* name){
+    size_t hash = 14695981039346656037ULL;
+    while(*name != '\0'){
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211ULL;
+        name++;
+    }
+    return hash;
+}
+
+name_map* create_name_map(string_table* strings){
+    void* to_return_v = malloc(sizeof(name_map));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_name_map() : Could not allocate space for name map struct\n");
+        return NULL;
+    }
+    name_map* to_return = (name_map*)to_return_v;
+    to_return->strings = strings;
+    to_return->length = 0;
+    to_return->capacity = 16;
+
+    to_return->keys = (uint32_t*)malloc(to_return->capacity * sizeof(uint32_t));
+    to_return->values = (uint32_t*)malloc(to_return->capacity * sizeof(uint32_t));
+    if(to_return->keys == NULL || to_return->values == NULL){
+        fprintf(stderr, "ERROR in create_name_map() : Could not allocate space for name map slots\n");
+        free(to_return->keys);
+        free(to_return->values);
+        free(to_return);
+        return NULL;
+    }
+    memset(to_return->keys, 0xff, to_return->capacity * sizeof(uint32_t)); //every slot NAME_MAP_EMPTY
+
+    return to_return;
+}
+
+size_t name_map_get(name_map* map, char* name){
+    size_t mask = map->capacity - 1;
+    size_t slot = hash_name(name) & mask;
+    while(map->keys[slot] != NAME_MAP_EMPTY){
+        if(strcmp(get_string(map->strings, map->keys[slot]), name) == 0){
+            return map->values[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NAME_NOT_FOUND;
+}
+
+/**
+ * Doubles the number of slots in the map and puts every key back in its new place
+ */
+static void grow_name_map(name_map* map){
+    size_t new_capacity = map->capacity * 2;
+    uint32_t* new_keys = (uint32_t*)malloc(new_capacity * sizeof(uint32_t));
+    uint32_t* new_values = (uint32_t*)malloc(new_capacity * sizeof(uint32_t));
+    if(new_keys == NULL || new_values == NULL){
+        fprintf(stderr, "ERROR in grow_name_map() : Could not allocate space for name map slots\n");
+        exit(EXIT_FAILURE);
+    }
+    memset(new_keys, 0xff, new_capacity * sizeof(uint32_t));
+
+    size_t mask = new_capacity - 1;
+    size_t i;
+    for(i = 0; i < map->capacity; i++){
+        if(map->keys[i] != NAME_MAP_EMPTY){
+            size_t slot = hash_name(get_string(map->strings, map->keys[i])) & mask;
+            while(new_keys[slot] != NAME_MAP_EMPTY){
+                slot = (slot + 1) & mask;
+            }
+            new_keys[slot] = map->keys[i];
+            new_values[slot] = map->values[i];
+        }
+    }
+
+    free(map->keys);
+    free(map->values);
+    map->keys = new_keys;
+    map->values = new_values;
+    map->capacity = new_capacity;
+}
+
+size_t name_map_put(name_map* map, uint32_t name, uint32_t value){
+    //Keep the map at most half full so probe sequences stay short
+    if((map->length + 1) * 2 > map->capacity){
+        grow_name_map(map);
+    }
+
+    char* name_str = get_string(map->strings, name);
+    size_t mask = map->capacity - 1;
+    size_t slot = hash_name(name_str) & mask;
+    while(map->keys[slot] != NAME_MAP_EMPTY){
+        if(strcmp(get_string(map->strings, map->keys[slot]), name_str) == 0){
+            return map->values[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    map->keys[slot] = name;
+    map->values[slot] = value;
+    map->length++;
+    return value;
+}
+
+void destroy_name_map(name_map* map){
+    free(map->keys);
+    free(map->values);
+    free(map);
+}
+
+//-----------------------HEAP IMPLEMENTATIONS-----------------------//
+
+/**
+ * Returns 1 if entry a belongs above entry b in the heap, 0 otherwise
+ */
+static int heap_entry_less(heap_entry a, heap_entry b){
+    if(a.key != b.key){
+        return a.key < b.key;
+    }
+    return a.index < b.index;
+}
+
+min_heap* create_min_heap(){
+    void* to_return_v = malloc(sizeof(min_heap));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_min_heap() : Could not allocate space for heap struct\n");
+        return NULL;
+    }
+    min_heap* to_return = (min_heap*)to_return_v;
+    to_return->entries = NULL;
+    to_return->length = 0;
+    to_return->capacity = 0;
+
+    return to_return;
+}
+
+void min_heap_push(min_heap* heap, size_t key, size_t index){
+    if(heap->length == heap->capacity){
+        size_t new_capacity = heap->capacity == 0 ? 16 : heap->capacity * 2;
+        void* entries_v = realloc(heap->entries, new_capacity * sizeof(heap_entry));
+        if(entries_v == NULL){
+            fprintf(stderr, "ERROR in min_heap_push() : Could not grow heap\n");
+            exit(EXIT_FAILURE);
+        }
+        heap->entries = (heap_entry*)entries_v;
+        heap->capacity = new_capacity;
+    }
+
+    heap_entry to_insert;
+    to_insert.key = key;
+    to_insert.index = index;
+
+    //Sift up from the end
+    size_t i = heap->length;
+    heap->length++;
+    while(i > 0){
+        size_t parent = (i - 1) / 2;
+        if(!heap_entry_less(to_insert, heap->entries[parent])){
+            break;
+        }
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i] = to_insert;
+}
+
+heap_entry min_heap_pop(min_heap* heap){
+    heap_entry to_return = heap->entries[0];
+    heap->length--;
+    if(heap->length == 0){
+        return to_return;
+    }
+
+    //Sift the last entry down from the root
+    heap_entry last = heap->entries[heap->length];
+    size_t i = 0;
+    while(1){
+        size_t child = 2 * i + 1;
+        if(child >= heap->length){
+            break;
+        }
+        if(child + 1 < heap->length && heap_entry_less(heap->entries[child + 1], heap->entries[child])){
+            child++;
+        }
+        if(!heap_entry_less(heap->entries[child], last)){
+            break;
+        }
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    heap->entries[i] = last;
+
+    return to_return;
+}
+
+void destroy_min_heap(min_heap* heap){
+    free(heap->entries);
+    free(heap);
+}
+
+//-----------------------SCHEDULE IMPLEMENTATIONS-----------------------//
+
+/**
+ * realloc()s one of the arrays a scheduler keeps per job (or per person) to hold new_capacity elements. Exits if it
+ *  can't
+ */
+static void* grow_scheduler_array(void* array, size_t new_capacity, size_t element_size){
+    void* array_v = realloc(array, (new_capacity + 1) * element_size);
+    if(array_v == NULL){
+        fprintf(stderr, "ERROR in grow_scheduler_array() : Could not grow scheduler state\n");
+        exit(EXIT_FAILURE);
+    }
+    return array_v;
+}
+
+schedule* create_schedule(size_t num_jobs, size_t num_cpus){
+    void* to_return_v = malloc(sizeof(schedule));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_schedule() : Could not allocate space for schedule struct\n");
+        return NULL;
+    }
+    schedule* to_return = (schedule*)to_return_v;
+    to_return->runs = NULL;
+    to_return->num_runs = 0;
+    to_return->capacity = 0;
+    to_return->makespan = 0;
+    to_return->num_rejected = 0;
+    to_return->num_cpus = num_cpus;
+
+    //calloc(0) is allowed to return NULL, so always ask for at least one
+    to_return->completion_times = (size_t*)calloc(num_jobs + 1, sizeof(size_t));
+    to_return->ready_times = (size_t*)calloc(num_jobs + 1, sizeof(size_t));
+    to_return->rejected = (char*)calloc(num_jobs + 1, sizeof(char));
+    to_return->last_run_on_cpu = (size_t*)calloc(num_cpus + 1, sizeof(size_t));
+    if(to_return->completion_times == NULL || to_return->ready_times == NULL || to_return->rejected == NULL || to_return->last_run_on_cpu == NULL){
+        fprintf(stderr, "ERROR in create_schedule() : Could not allocate space for completion times\n");
+        free(to_return->completion_times);
+        free(to_return->ready_times);
+        free(to_return->rejected);
+        free(to_return->last_run_on_cpu);
+        free(to_return);
+        return NULL;
+    }
+    size_t i;
+    for(i = 0; i < num_cpus; i++){
+        to_return->last_run_on_cpu[i] = SIZE_MAX;
+    }
+
+    return to_return;
+}
+
+void grow_schedule(schedule* s, size_t old_num_jobs, size_t num_jobs){
+    s->completion_times = (size_t*)grow_scheduler_array(s->completion_times, num_jobs, sizeof(size_t));
+    s->ready_times = (size_t*)grow_scheduler_array(s->ready_times, num_jobs, sizeof(size_t));
+    s->rejected = (char*)grow_scheduler_array(s->rejected, num_jobs, sizeof(char));
+    memset(s->completion_times + old_num_jobs, 0, (num_jobs - old_num_jobs) * sizeof(size_t));
+    memset(s->ready_times + old_num_jobs, 0, (num_jobs - old_num_jobs) * sizeof(size_t));
+    memset(s->rejected + old_num_jobs, 0, (num_jobs - old_num_jobs) * sizeof(char));
+}
+
+void add_run_to_schedule(schedule* s, size_t job_index, size_t cpu, size_t start, size_t end){
+    if(start == end){
+        return;
+    }
+
+    if(s->last_run_on_cpu[cpu] != SIZE_MAX){
+        run* last = &s->runs[s->last_run_on_cpu[cpu]];
+        if(last->job_index == job_index && last->end == start){
+            last->end = end;
+            return;
+        }
+    }
+
+    if(s->num_runs == s->capacity){
+        size_t new_capacity = s->capacity == 0 ? 16 : s->capacity * 2;
+        void* runs_v = realloc(s->runs, new_capacity * sizeof(run));
+        if(runs_v == NULL){
+            fprintf(stderr, "ERROR in add_run_to_schedule() : Could not grow schedule\n");
+            exit(EXIT_FAILURE);
+        }
+        s->runs = (run*)runs_v;
+        s->capacity = new_capacity;
+    }
+
+    s->runs[s->num_runs].job_index = (uint32_t)job_index;
+    s->runs[s->num_runs].cpu = (uint32_t)cpu;
+    s->runs[s->num_runs].start = start;
+    s->runs[s->num_runs].end = end;
+    s->last_run_on_cpu[cpu] = s->num_runs;
+    s->num_runs++;
+}
+
+void destroy_schedule(schedule* s){
+    free(s->runs);
+    free(s->completion_times);
+    free(s->ready_times);
+    free(s->rejected);
+    free(s->last_run_on_cpu);
+    free(s);
+}
+
+//-----------------------DEPENDENCY IMPLEMENTATIONS-----------------------//
+
+dependency_graph* build_dependency_graph(job_table* table){
+    size_t n = table->length;
+
+    void* graph_v = malloc(sizeof(dependency_graph));
+    if(graph_v == NULL){
+        fprintf(stderr, "ERROR in build_dependency_graph() : Could not allocate space for graph struct\n");
+        exit(EXIT_FAILURE);
+    }
+    dependency_graph* graph = (dependency_graph*)graph_v;
+
+    //There's an edge for every prerequisite name. They get counted up per prerequisite, then laid out back to back
+    size_t num_edges = table->num_prerequisites;
+    size_t i;
+    graph->dependent_offsets = (size_t*)calloc(n + 1, sizeof(size_t));
+    graph->dependents = (size_t*)malloc((num_edges + 1) * sizeof(size_t));
+    graph->num_unmet = (size_t*)calloc(n + 1, sizeof(size_t));
+    if(graph->dependent_offsets == NULL || graph->dependents == NULL || graph->num_unmet == NULL){
+        fprintf(stderr, "ERROR in build_dependency_graph() : Could not allocate space for graph edges\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if(!table->has_dependencies){
+        //Nothing waits on anything, every job is free to go once it arrives
+        return graph;
+    }
+
+    //Prerequisites are given by name, so job names have to be unique to know which job is meant
+    name_map* job_names = create_name_map(table->strings);
+    if(job_names == NULL){
+        fprintf(stderr, "ERROR in build_dependency_graph() : Could not allocate space for job name map\n");
+        exit(EXIT_FAILURE);
+    }
+    for(i = 0; i < n; i++){
+        if(name_map_put(job_names, table->job_names[i], (uint32_t)i) != i){
+            fprintf(stderr, "ERROR in build_dependency_graph() : Job name %s is used more than once, so it can't be used as a prerequisite\n", get_job_name(table, i));
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    //Resolve every name, counting how many dependents each prerequisite has. The resolved jobs are kept in the same
+    // order as the names, so they share the table's prerequisite offsets
+    void* prerequisites_v = malloc((num_edges + 1) * sizeof(size_t));
+    if(prerequisites_v == NULL){
+        fprintf(stderr, "ERROR in build_dependency_graph() : Could not allocate space for resolved prerequisites\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t* prerequisites = (size_t*)prerequisites_v;
+    size_t edge;
+    for(i = 0; i < n; i++){
+        for(edge = table->prerequisite_offsets[i]; edge < table->prerequisite_offsets[i + 1]; edge++){
+            char* prerequisite_name = get_string(table->strings, table->prerequisite_names[edge]);
+            size_t prerequisite = name_map_get(job_names, prerequisite_name);
+            if(prerequisite == NAME_NOT_FOUND){
+                fprintf(stderr, "ERROR in build_dependency_graph() : Job %s depends on %s, which doesn't exist\n", get_job_name(table, i), prerequisite_name);
+                exit(EXIT_FAILURE);
+            }
+            prerequisites[edge] = prerequisite;
+            graph->dependent_offsets[prerequisite + 1]++;
+        }
+        graph->num_unmet[i] = table->prerequisite_offsets[i + 1] - table->prerequisite_offsets[i];
+    }
+    destroy_name_map(job_names);
+
+    //Turn the counts into offsets, then drop every edge into its prerequisite's range
+    for(i = 0; i < n; i++){
+        graph->dependent_offsets[i + 1] += graph->dependent_offsets[i];
+    }
+    void* next_slot_v = malloc((n + 1) * sizeof(size_t));
+    if(next_slot_v == NULL){
+        fprintf(stderr, "ERROR in build_dependency_graph() : Could not allocate space for edge offsets\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t* next_slot = (size_t*)next_slot_v;
+    memcpy(next_slot, graph->dependent_offsets, (n + 1) * sizeof(size_t));
+    for(i = 0; i < n; i++){
+        for(edge = table->prerequisite_offsets[i]; edge < table->prerequisite_offsets[i + 1]; edge++){
+            graph->dependents[next_slot[prerequisites[edge]]++] = i;
+        }
+    }
+    free(next_slot);
+
+    int has_cycle = check_for_cycles(table, graph, prerequisites);
+    free(prerequisites);
+    if(has_cycle){
+        exit(EXIT_FAILURE);
+    }
+
+    return graph;
+}
+
+int check_for_cycles(job_table* table, dependency_graph* graph, size_t* prerequisites){
+    size_t n = table->length;
+    size_t* unmet = (size_t*)malloc((n + 1) * sizeof(size_t));
+    size_t* queue = (size_t*)malloc((n + 1) * sizeof(size_t));
+    if(unmet == NULL || queue == NULL){
+        fprintf(stderr, "ERROR in check_for_cycles() : Could not allocate space for search\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(unmet, graph->num_unmet, n * sizeof(size_t));
+
+    //Kahn's algorithm: keep finishing jobs that have nothing left to wait on
+    size_t queue_start = 0;
+    size_t queue_end = 0;
+    size_t i, k;
+    for(i = 0; i < n; i++){
+        if(unmet[i] == 0){
+            queue[queue_end++] = i;
+        }
+    }
+    while(queue_start < queue_end){
+        size_t finished = queue[queue_start++];
+        for(k = graph->dependent_offsets[finished]; k < graph->dependent_offsets[finished + 1]; k++){
+            size_t dependent = graph->dependents[k];
+            unmet[dependent]--;
+            if(unmet[dependent] == 0){
+                queue[queue_end++] = dependent;
+            }
+        }
+    }
+    free(queue);
+
+    if(queue_end == n){
+        free(unmet);
+        return 0;
+    }
+
+    //Some job never ran. Every such job has a prerequisite that also never ran, so following those back n times
+    // is guaranteed to land inside a cycle. Then follow it around once more to print it.
+    size_t curr = 0;
+    while(unmet[curr] == 0){
+        curr++;
+    }
+    size_t steps;
+    for(steps = 0; steps < n; steps++){
+        for(k = table->prerequisite_offsets[curr]; k < table->prerequisite_offsets[curr + 1]; k++){
+            if(unmet[prerequisites[k]] != 0){
+                curr = prerequisites[k];
+                break;
+            }
+        }
+    }
+
+    fprintf(stderr, "ERROR in check_for_cycles() : Dependency cycle found : %s", get_job_name(table, curr));
+    size_t start = curr;
+    do{
+        for(k = table->prerequisite_offsets[curr]; k < table->prerequisite_offsets[curr + 1]; k++){
+            if(unmet[prerequisites[k]] != 0){
+                curr = prerequisites[k];
+                break;
+            }
+        }
+        fprintf(stderr, " <- %s", get_job_name(table, curr));
+    }while(curr != start);
+    fprintf(stderr, "\n");
+
+    free(unmet);
+    return -1;
+}
+
+void destroy_dependency_graph(dependency_graph* graph){
+    free(graph->dependent_offsets);
+    free(graph->dependents);
+    free(graph->num_unmet);
+    free(graph);
+}
+
+//-----------------------ADMISSION IMPLEMENTATIONS-----------------------//
+
+admission_tree* create_admission_tree(size_t num_jobs, size_t num_cpus){
+    void* to_return_v = malloc(sizeof(admission_tree));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_admission_tree() : Could not allocate space for admission tree struct\n");
+        return NULL;
+    }
+    admission_tree* to_return = (admission_tree*)to_return_v;
+    to_return->root = ADMISSION_NIL;
+    to_return->num_cpus = num_cpus;
+
+    to_return->nodes = (admission_node*)malloc((num_jobs + 1) * sizeof(admission_node));
+    if(to_return->nodes == NULL){
+        fprintf(stderr, "ERROR in create_admission_tree() : Could not allocate space for admission tree nodes\n");
+        free(to_return);
+        return NULL;
+    }
+
+    return to_return;
+}
+
+void grow_admission_tree(admission_tree* tree, size_t num_jobs){
+    tree->nodes = (admission_node*)grow_scheduler_array(tree->nodes, num_jobs, sizeof(admission_node));
+}
+
+/**
+ * Returns 1 if node a comes before node b in deadline order, 0 otherwise
+ */
+static int admission_before(admission_tree* tree, size_t a, size_t b){
+    if(tree->nodes[a].deadline != tree->nodes[b].deadline){
+        return tree->nodes[a].deadline < tree->nodes[b].deadline;
+    }
+    return a < b;
+}
+
+/**
+ * How much work the tree's CPUs can get through by time. Checked rather than trusted to fit, though read_jobs() and
+ *  the option limits keep it to MAX_TIME_SLOT * MAX_CPUS
+ */
+static long long admission_capacity(admission_tree* tree, size_t time){
+    if(time > (size_t)(LLONG_MAX / 4) / tree->num_cpus){
+        fprintf(stderr, "ERROR in admission_capacity() : Time slot %zu on %zu CPUs is too far out to check deadlines against\n", time, tree->num_cpus);
+        exit(EXIT_FAILURE);
+    }
+    return (long long)(time * tree->num_cpus);
+}
+
+/**
+ * Recomputes a node's subtree totals from its children
+ */
+static void admission_update(admission_tree* tree, size_t x){
+    admission_node* n = &tree->nodes[x];
+    long long left_work = 0;
+    n->worst_lateness = LLONG_MIN;
+    if(n->left != ADMISSION_NIL){
+        left_work = tree->nodes[n->left].total_work;
+        n->worst_lateness = tree->nodes[n->left].worst_lateness;
+    }
+
+    long long finish = left_work + n->work;
+    long long lateness = finish - admission_capacity(tree, n->deadline);
+    if(lateness > n->worst_lateness){
+        n->worst_lateness = lateness;
+    }
+
+    n->total_work = finish;
+    if(n->right != ADMISSION_NIL){
+        n->total_work += tree->nodes[n->right].total_work;
+        lateness = finish + tree->nodes[n->right].worst_lateness;
+        if(lateness > n->worst_lateness){
+            n->worst_lateness = lateness;
+        }
+    }
+}
+
+static size_t admission_rotate_right(admission_tree* tree, size_t y){
+    size_t x = tree->nodes[y].left;
+    tree->nodes[y].left = tree->nodes[x].right;
+    tree->nodes[x].right = y;
+    admission_update(tree, y);
+    admission_update(tree, x);
+    return x;
+}
+
+static size_t admission_rotate_left(admission_tree* tree, size_t x){
+    size_t y = tree->nodes[x].right;
+    tree->nodes[x].right = tree->nodes[y].left;
+    tree->nodes[y].left = x;
+    admission_update(tree, x);
+    admission_update(tree, y);
+    return y;
+}
+
+/**
+ * Inserts node x into the subtree at root
+ * Returns the new root of the subtree
+ */
+static size_t admission_insert(admission_tree* tree, size_t root, size_t x){
+    if(root == ADMISSION_NIL){
+        admission_update(tree, x);
+        return x;
+    }
+    if(admission_before(tree, x, root)){
+        tree->nodes[root].left = admission_insert(tree, tree->nodes[root].left, x);
+        if(tree->nodes[tree->nodes[root].left].priority > tree->nodes[root].priority){
+            return admission_rotate_right(tree, root);
+        }
+    }else{
+        tree->nodes[root].right = admission_insert(tree, tree->nodes[root].right, x);
+        if(tree->nodes[tree->nodes[root].right].priority > tree->nodes[root].priority){
+            return admission_rotate_left(tree, root);
+        }
+    }
+    admission_update(tree, root);
+    return root;
+}
+
+/**
+ * Joins two subtrees where everything in a comes before everything in b
+ * Returns the root of the joined subtree
+ */
+static size_t admission_merge(admission_tree* tree, size_t a, size_t b){
+    if(a == ADMISSION_NIL){
+        return b;
+    }
+    if(b == ADMISSION_NIL){
+        return a;
+    }
+    if(tree->nodes[a].priority > tree->nodes[b].priority){
+        tree->nodes[a].right = admission_merge(tree, tree->nodes[a].right, b);
+        admission_update(tree, a);
+        return a;
+    }
+    tree->nodes[b].left = admission_merge(tree, a, tree->nodes[b].left);
+    admission_update(tree, b);
+    return b;
+}
+
+/**
+ * Removes node x from the subtree at root
+ * Returns the new root of the subtree
+ */
+static size_t admission_remove(admission_tree* tree, size_t root, size_t x){
+    if(root == x){
+        return admission_merge(tree, tree->nodes[x].left, tree->nodes[x].right);
+    }
+    if(admission_before(tree, x, root)){
+        tree->nodes[root].left = admission_remove(tree, tree->nodes[root].left, x);
+    }else{
+        tree->nodes[root].right = admission_remove(tree, tree->nodes[root].right, x);
+    }
+    admission_update(tree, root);
+    return root;
+}
+
+/**
+ * Finds the worst lateness over every node in the subtree at root that doesn't come before node x.
+ * offset is the work of everything before the subtree.
+ */
+static long long admission_worst_from(admission_tree* tree, size_t root, size_t x, long long offset){
+    long long worst = LLONG_MIN;
+    while(root != ADMISSION_NIL){
+        admission_node* n = &tree->nodes[root];
+        long long left_work = n->left == ADMISSION_NIL ? 0 : tree->nodes[n->left].total_work;
+        if(admission_before(tree, root, x)){
+            //This node and everything left of it is before x, only the right side counts
+            offset += left_work + n->work;
+            root = n->right;
+            continue;
+        }
+
+        //This node and everything right of it count
+        long long finish = offset + left_work + n->work;
+        long long lateness = finish - admission_capacity(tree, n->deadline);
+        if(lateness > worst){
+            worst = lateness;
+        }
+        if(n->right != ADMISSION_NIL && finish + tree->nodes[n->right].worst_lateness > worst){
+            worst = finish + tree->nodes[n->right].worst_lateness;
+        }
+        root = n->left;
+    }
+    return worst;
+}
+
+/**
+ * Mixes a job index into a treap priority. Deterministic, so the same input always builds the same tree.
+ */
+static size_t admission_priority(size_t job_index){
+    unsigned long long z = (unsigned long long)job_index + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return (size_t)(z ^ (z >> 31));
+}
+
+int admission_tree_admit(admission_tree* tree, size_t job_index, size_t deadline, size_t work, size_t time){
+    if(time + work > deadline){
+        //Can't make it even with a CPU to itself
+        return -1;
+    }
+
+    admission_node* n = &tree->nodes[job_index];
+    n->left = ADMISSION_NIL;
+    n->right = ADMISSION_NIL;
+    n->priority = admission_priority(job_index);
+    n->deadline = deadline;
+    n->work = (long long)work;
+
+    //Jobs before the new one in deadline order aren't affected by it, so only check it and everything after it
+    tree->root = admission_insert(tree, tree->root, job_index);
+    long long worst = admission_worst_from(tree, tree->root, job_index, 0);
+    if(admission_capacity(tree, time) + worst > 0){
+        tree->root = admission_remove(tree, tree->root, job_index);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Changes node x's work, fixing up the totals on the way back up from it
+ */
+static void admission_set_work(admission_tree* tree, size_t root, size_t x, long long work){
+    if(root == x){
+        tree->nodes[x].work = work;
+    }else if(admission_before(tree, x, root)){
+        admission_set_work(tree, tree->nodes[root].left, x, work);
+    }else{
+        admission_set_work(tree, tree->nodes[root].right, x, work);
+    }
+    admission_update(tree, root);
+}
+
+void admission_tree_set_work(admission_tree* tree, size_t job_index, size_t work){
+    if(work == 0){
+        tree->root = admission_remove(tree, tree->root, job_index);
+    }else{
+        admission_set_work(tree, tree->root, job_index, (long long)work);
+    }
+}
+
+void destroy_admission_tree(admission_tree* tree){
+    free(tree->nodes);
+    free(tree);
+}
+
+//-----------------------TRACE IMPLEMENTATIONS-----------------------//
+
+static void trace_flush(trace_writer* tw){
+    if(tw->length > 0 && fwrite(tw->buffer, sizeof(char), tw->length, tw->stream) != tw->length){
+        fprintf(stderr, "ERROR in trace_flush() : Could not write to %s : %s\n", tw->path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    tw->length = 0;
+}
+
+/**
+ * Appends length bytes of text to the buffer as they are, flushing first if they don't fit
+ */
+static void trace_write(trace_writer* tw, const char* text, size_t length){
+    if(tw->length + length > TRACE_BUFFER_SIZE){
+        trace_flush(tw);
+        if(length > TRACE_BUFFER_SIZE){
+            //Too big to ever fit, so it skips the buffer
+            if(fwrite(text, sizeof(char), length, tw->stream) != length){
+                fprintf(stderr, "ERROR in trace_write() : Could not write to %s : %s\n", tw->path, strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            return;
+        }
+    }
+    memcpy(tw->buffer + tw->length, text, length);
+    tw->length += length;
+}
+
+static void trace_write_text(trace_writer* tw, const char* text){
+    trace_write(tw, text, strlen(text));
+}
+
+/**
+ * Appends a number. Every event has a few of these, and doing them by hand is a lot quicker than going through printf
+ */
+static void trace_write_size(trace_writer* tw, size_t value){
+    char digits[24];
+    size_t num_digits = 0;
+    do{
+        digits[sizeof(digits) - 1 - num_digits] = (char)('0' + value % 10);
+        num_digits++;
+        value /= 10;
+    }while(value > 0);
+    trace_write(tw, digits + sizeof(digits) - num_digits, num_digits);
+}
+
+/**
+ * Appends formatted text to the buffer. Only used for the fixed parts of events, which are always far shorter than
+ *  the buffer, names go through trace_write_string()
+ */
+static void trace_printf(trace_writer* tw, const char* format, ...){
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(tw->buffer + tw->length, TRACE_BUFFER_SIZE - tw->length, format, args);
+    va_end(args);
+    if(written < 0){
+        fprintf(stderr, "ERROR in trace_printf() : Could not format trace event\n");
+        exit(EXIT_FAILURE);
+    }
+    if((size_t)written >= TRACE_BUFFER_SIZE - tw->length){
+        //Didn't fit, so make room and have another go
+        trace_flush(tw);
+        va_start(args, format);
+        written = vsnprintf(tw->buffer, TRACE_BUFFER_SIZE, format, args);
+        va_end(args);
+        if(written < 0 || (size_t)written >= TRACE_BUFFER_SIZE){
+            fprintf(stderr, "ERROR in trace_printf() : Trace event is too long\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    tw->length += (size_t)written;
+}
+
+/**
+ * Appends str as a quoted JSON string, escaping anything JSON doesn't allow as is
+ */
+static void trace_write_string(trace_writer* tw, char* str){
+    trace_write_text(tw, "\"");
+
+    //Names almost never need escaping, so check first and copy the whole thing in one go if they don't
+    size_t i;
+    for(i = 0; str[i] != '\0' && str[i] != '"' && str[i] != '\\' && (unsigned char)str[i] >= 0x20; i++);
+    if(str[i] == '\0'){
+        trace_write(tw, str, i);
+        trace_write_text(tw, "\"");
+        return;
+    }
+
+    for(i = 0; str[i] != '\0'; i++){
+        unsigned char ch = (unsigned char)str[i];
+        if(tw->length + 6 >= TRACE_BUFFER_SIZE){
+            trace_flush(tw);
+        }
+        if(ch == '"' || ch == '\\'){
+            tw->buffer[tw->length++] = '\\';
+            tw->buffer[tw->length++] = (char)ch;
+        }else if(ch < 0x20){
+            tw->length += (size_t)snprintf(tw->buffer + tw->length, 7, "\\u%04x", ch);
+        }else{
+            tw->buffer[tw->length++] = (char)ch;
+        }
+    }
+    trace_write_text(tw, "\"");
+}
+
+/**
+ * Starts a new event, putting a comma between it and the last one
+ */
+static void trace_start_event(trace_writer* tw){
+    if(tw->num_events == 0){
+        trace_write_text(tw, "\n");
+    }else{
+        trace_write_text(tw, ",\n");
+    }
+    tw->num_events++;
+}
+
+static void trace_name_lane(trace_writer* tw, size_t lane, char* name){
+    trace_start_event(tw);
+    trace_printf(tw, "{\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"name\":\"thread_name\",\"args\":{\"name\":", lane);
+    trace_write_string(tw, name);
+    trace_write_text(tw, "}}");
+    trace_start_event(tw);
+    trace_printf(tw, "{\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%zu}}", lane, lane);
+}
+
+trace_writer* create_trace_writer(char* path, size_t num_cpus){
+    void* to_return_v = malloc(sizeof(trace_writer));
+    void* buffer_v = malloc(TRACE_BUFFER_SIZE * sizeof(char));
+    if(to_return_v == NULL || buffer_v == NULL){
+        fprintf(stderr, "ERROR in create_trace_writer() : Could not allocate space for trace buffer\n");
+        exit(EXIT_FAILURE);
+    }
+    trace_writer* tw = (trace_writer*)to_return_v;
+    tw->buffer = (char*)buffer_v;
+    tw->length = 0;
+    tw->num_events = 0;
+    tw->path = path;
+    tw->jobs_lane = num_cpus;
+    tw->stream = fopen(path, "w");
+    if(tw->stream == NULL){
+        fprintf(stderr, "ERROR in create_trace_writer() : Could not open %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    trace_printf(tw, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    trace_start_event(tw);
+    trace_printf(tw, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Job-Sorter\"}}");
+    char lane_name[32];
+    size_t c;
+    for(c = 0; c < num_cpus; c++){
+        snprintf(lane_name, sizeof(lane_name), "CPU %zu", c);
+        trace_name_lane(tw, c, lane_name);
+    }
+    trace_name_lane(tw, tw->jobs_lane, "Jobs");
+
+    return tw;
+}
+
+void trace_job_event(trace_writer* tw, job_table* table, char* name, size_t job_index, size_t cpu, size_t time){
+    trace_start_event(tw);
+    trace_write_text(tw, "{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":");
+    trace_write_size(tw, cpu == SIZE_MAX ? tw->jobs_lane : cpu);
+    trace_write_text(tw, ",\"ts\":");
+    trace_write_size(tw, time * TRACE_MICROSECONDS_PER_SLOT);
+    trace_write_text(tw, ",\"cat\":\"job\",\"name\":");
+    trace_write_string(tw, name);
+    trace_write_text(tw, ",\"args\":{\"job\":");
+    trace_write_string(tw, get_job_name(table, job_index));
+    trace_write_text(tw, ",\"person\":");
+    trace_write_string(tw, get_person_name(table, table->person_ids[job_index]));
+    trace_write_text(tw, "}}");
+}
+
+void trace_queue_depth(trace_writer* tw, size_t time, size_t waiting, size_t running){
+    trace_start_event(tw);
+    trace_write_text(tw, "{\"ph\":\"C\",\"pid\":1,\"tid\":");
+    trace_write_size(tw, tw->jobs_lane);
+    trace_write_text(tw, ",\"ts\":");
+    trace_write_size(tw, time * TRACE_MICROSECONDS_PER_SLOT);
+    trace_write_text(tw, ",\"name\":\"Ready queue\",\"args\":{\"waiting\":");
+    trace_write_size(tw, waiting);
+    trace_write_text(tw, ",\"running\":");
+    trace_write_size(tw, running);
+    trace_write_text(tw, "}}");
+}
+
+void trace_schedule(trace_writer* tw, schedule* s, job_table* table){
+    size_t r;
+    for(r = 0; r < s->num_runs; r++){
+        run* curr_run = &s->runs[r];
+        trace_start_event(tw);
+        trace_write_text(tw, "{\"ph\":\"X\",\"pid\":1,\"tid\":");
+        trace_write_size(tw, curr_run->cpu);
+        trace_write_text(tw, ",\"ts\":");
+        trace_write_size(tw, curr_run->start * TRACE_MICROSECONDS_PER_SLOT);
+        trace_write_text(tw, ",\"dur\":");
+        trace_write_size(tw, (curr_run->end - curr_run->start) * TRACE_MICROSECONDS_PER_SLOT);
+        trace_write_text(tw, ",\"cat\":\"run\",\"name\":");
+        trace_write_string(tw, get_job_name(table, curr_run->job_index));
+        trace_write_text(tw, ",\"args\":{\"person\":");
+        trace_write_string(tw, get_person_name(table, table->person_ids[curr_run->job_index]));
+        trace_write_text(tw, "}}");
+    }
+}
+
+void destroy_trace_writer(trace_writer* tw){
+    trace_printf(tw, "\n]}\n");
+    trace_flush(tw);
+    if(fclose(tw->stream) != 0){
+        fprintf(stderr, "ERROR in destroy_trace_writer() : Could not finish writing %s : %s\n", tw->path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    free(tw->buffer);
+    free(tw);
+}
+
+//-----------------------SCHEDULER IMPLEMENTATIONS-----------------------//
+
+/**
+ * Returns how far a time slot moves the virtual time of someone with the given weight
+ */
+static size_t weight_to_virtual_time(size_t weight){
+    size_t virtual_time_per_slot = VIRTUAL_TIME_SCALE / weight;
+    if(virtual_time_per_slot == 0){
+        //Weight is bigger than the scale, the person still has to use something up or they'd never give up the CPU
+        virtual_time_per_slot = 1;
+    }
+    return virtual_time_per_slot;
+}
+
+ready_queue* create_ready_queue(job_table* table, scheduler_config* config){
+    void* to_return_v = malloc(sizeof(ready_queue));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_ready_queue() : Could not allocate space for ready queue struct\n");
+        exit(EXIT_FAILURE);
+    }
+    ready_queue* q = (ready_queue*)to_return_v;
+    q->policy = config->policy;
+    q->length = 0;
+    q->num_people = table->num_people;
+    q->jobs_capacity = table->length;
+    q->people_capacity = table->num_people;
+    q->jobs = NULL;
+    q->admission = NULL;
+    q->people = NULL;
+    q->person_jobs = NULL;
+    q->virtual_times = NULL;
+    q->virtual_time_per_slot = NULL;
+    q->person_queued = NULL;
+    q->system_virtual_time = 0;
+    q->held = NULL;
+    q->slice_left = NULL;
+    q->next_ticket = 0;
+    q->quantum = config->quantum;
+    q->tickets = NULL;
+    q->slots_used = NULL;
+    q->keeping_changes = 0;
+    q->changes = NULL;
+    q->num_changes = 0;
+    q->changes_capacity = 0;
+
+    if(q->policy != POLICY_FAIR_SHARE){
+        q->jobs = create_min_heap();
+        if(q->jobs == NULL){
+            fprintf(stderr, "ERROR in create_ready_queue() : Could not allocate space for job heap\n");
+            exit(EXIT_FAILURE);
+        }
+        if(q->policy == POLICY_ROUND_ROBIN){
+            q->tickets = (size_t*)malloc((table->length + 1) * sizeof(size_t));
+            q->slots_used = (size_t*)malloc((table->length + 1) * sizeof(size_t));
+            if(q->tickets == NULL || q->slots_used == NULL){
+                fprintf(stderr, "ERROR in create_ready_queue() : Could not allocate space for round robin state\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if(q->policy == POLICY_EDF){
+            q->admission = create_admission_tree(table->length, config->num_cpus);
+            if(q->admission == NULL){
+                fprintf(stderr, "ERROR in create_ready_queue() : Could not allocate space for admission tree\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        return q;
+    }
+
+    size_t num_people = table->num_people;
+    q->people = create_min_heap();
+    q->person_jobs = (min_heap**)calloc(num_people + 1, sizeof(min_heap*));
+    q->virtual_times = (size_t*)calloc(num_people + 1, sizeof(size_t));
+    q->virtual_time_per_slot = (size_t*)malloc((num_people + 1) * sizeof(size_t));
+    q->person_queued = (char*)calloc(num_people + 1, sizeof(char));
+    q->held = create_min_heap();
+    q->slice_left = (size_t*)malloc((table->length + 1) * sizeof(size_t));
+    if(q->people == NULL || q->person_jobs == NULL || q->virtual_times == NULL || q->virtual_time_per_slot == NULL || q->person_queued == NULL
+        || q->held == NULL || q->slice_left == NULL){
+        fprintf(stderr, "ERROR in create_ready_queue() : Could not allocate space for fair share state\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t i;
+    for(i = 0; i < num_people; i++){
+        q->virtual_time_per_slot[i] = weight_to_virtual_time(config->weights == NULL ? DEFAULT_WEIGHT : config->weights[i]);
+    }
+
+    return q;
+}
+
+void ready_queue_add_jobs(ready_queue* q, job_table* table){
+    if(table->length > q->jobs_capacity){
+        size_t new_capacity = q->jobs_capacity * 2 < table->length ? table->length : q->jobs_capacity * 2;
+        if(q->tickets != NULL){
+            q->tickets = (size_t*)grow_scheduler_array(q->tickets, new_capacity, sizeof(size_t));
+            q->slots_used = (size_t*)grow_scheduler_array(q->slots_used, new_capacity, sizeof(size_t));
+        }
+        if(q->admission != NULL){
+            grow_admission_tree(q->admission, new_capacity);
+        }
+        if(q->slice_left != NULL){
+            q->slice_left = (size_t*)grow_scheduler_array(q->slice_left, new_capacity, sizeof(size_t));
+        }
+        q->jobs_capacity = new_capacity;
+    }
+
+    if(q->policy != POLICY_FAIR_SHARE || table->num_people <= q->num_people){
+        return;
+    }
+    if(table->num_people > q->people_capacity){
+        size_t new_capacity = q->people_capacity * 2 < table->num_people ? table->num_people : q->people_capacity * 2;
+        q->person_jobs = (min_heap**)grow_scheduler_array(q->person_jobs, new_capacity, sizeof(min_heap*));
+        q->virtual_times = (size_t*)grow_scheduler_array(q->virtual_times, new_capacity, sizeof(size_t));
+        q->virtual_time_per_slot = (size_t*)grow_scheduler_array(q->virtual_time_per_slot, new_capacity, sizeof(size_t));
+        q->person_queued = (char*)grow_scheduler_array(q->person_queued, new_capacity, sizeof(char));
+        q->people_capacity = new_capacity;
+    }
+    size_t i;
+    for(i = q->num_people; i < table->num_people; i++){
+        q->person_jobs[i] = NULL;
+        q->virtual_times[i] = 0;
+        q->virtual_time_per_slot[i] = weight_to_virtual_time(DEFAULT_WEIGHT);
+        q->person_queued[i] = 0;
+    }
+    q->num_people = table->num_people;
+}
+
+void ready_queue_rewind(ready_queue* q, size_t next_ticket, size_t system_virtual_time, size_t num_changes){
+    q->length = 0;
+    q->next_ticket = next_ticket;
+    q->system_virtual_time = system_virtual_time;
+    if(q->jobs != NULL){
+        q->jobs->length = 0;
+    }
+    if(q->admission != NULL){
+        q->admission->root = ADMISSION_NIL;
+    }
+    if(q->policy != POLICY_FAIR_SHARE){
+        return;
+    }
+
+    //Whatever is left in the people heap is out of date once everyone's jobs are gone, so it can all go
+    q->people->length = 0;
+    q->held->length = 0;
+    size_t i;
+    for(i = 0; i < q->num_people; i++){
+        if(q->person_jobs[i] != NULL){
+            q->person_jobs[i]->length = 0;
+        }
+        q->person_queued[i] = 0;
+    }
+    while(q->num_changes > num_changes){
+        q->num_changes--;
+        q->virtual_times[q->changes[q->num_changes].person] = q->changes[q->num_changes].virtual_time;
+    }
+}
+
+/**
+ * Changes a person's virtual time, noting down what it was first if the queue is keeping its changes
+ */
+static void set_virtual_time(ready_queue* q, size_t person, size_t virtual_time){
+    if(q->keeping_changes){
+        if(q->num_changes == q->changes_capacity){
+            q->changes_capacity = q->changes_capacity == 0 ? 64 : q->changes_capacity * 2;
+            q->changes = (virtual_time_change*)grow_scheduler_array(q->changes, q->changes_capacity, sizeof(virtual_time_change));
+        }
+        q->changes[q->num_changes].person = person;
+        q->changes[q->num_changes].virtual_time = q->virtual_times[person];
+        q->num_changes++;
+    }
+    q->virtual_times[person] = virtual_time;
+}
+
+/**
+ * Returns the key a job is ordered by in the single level heap
+ */
+static size_t ready_queue_job_key(ready_queue* q, job_table* table, size_t job_index, size_t remaining){
+    if(q->policy == POLICY_EDF){
+        return table->deadlines[job_index];
+    }
+    if(q->policy == POLICY_ROUND_ROBIN){
+        return q->tickets[job_index];
+    }
+    return remaining;
+}
+
+/**
+ * Throws away entries at the top of the people heap that are out of date: the person's virtual time has moved on since,
+ *  or all of their ready jobs have been taken
+ */
+static void drop_stale_people(ready_queue* q){
+    while(q->people->length > 0){
+        heap_entry top = q->people->entries[0];
+        if(q->person_queued[top.index] && top.key == q->virtual_times[top.index] && q->person_jobs[top.index]->length > 0){
+            return;
+        }
+        if(top.key == q->virtual_times[top.index]){
+            //This was their up to date entry, they just have nothing left to run
+            q->person_queued[top.index] = 0;
+        }
+        min_heap_pop(q->people);
+    }
+}
+
+int ready_queue_push(ready_queue* q, job_table* table, size_t job_index, size_t remaining, size_t time){
+    if(q->policy == POLICY_EDF){
+        size_t deadline = table->deadlines[job_index];
+        if(deadline != NO_DEADLINE && remaining > 0 && admission_tree_admit(q->admission, job_index, deadline, remaining, time) != 0){
+            return -1;
+        }
+    }
+
+    q->length++;
+    if(q->policy != POLICY_FAIR_SHARE){
+        if(q->policy == POLICY_ROUND_ROBIN){
+            q->tickets[job_index] = q->next_ticket++;
+            q->slots_used[job_index] = 0;
+        }
+        min_heap_push(q->jobs, ready_queue_job_key(q, table, job_index, remaining), job_index);
+        return 0;
+    }
+
+    size_t person = table->person_ids[job_index];
+    if(q->person_jobs[person] == NULL){
+        q->person_jobs[person] = create_min_heap();
+        if(q->person_jobs[person] == NULL){
+            fprintf(stderr, "ERROR in ready_queue_push() : Could not allocate space for person's job heap\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    min_heap_push(q->person_jobs[person], remaining, job_index);
+
+    if(!q->person_queued[person]){
+        //Someone who had nothing to run doesn't get to bank the time they spent idle, otherwise they'd hog the CPU
+        // when they came back. So they start no further behind than whoever is running now.
+        if(q->virtual_times[person] < q->system_virtual_time){
+            set_virtual_time(q, person, q->system_virtual_time);
+        }
+        min_heap_push(q->people, q->virtual_times[person], person);
+        q->person_queued[person] = 1;
+    }
+    return 0;
+}
+
+size_t ready_queue_pop(ready_queue* q, job_table* table, size_t* max_slots){
+    q->length--;
+    if(q->policy != POLICY_FAIR_SHARE){
+        size_t job_index = min_heap_pop(q->jobs).index;
+        *max_slots = SIZE_MAX;
+        if(q->policy == POLICY_ROUND_ROBIN && q->quantum > 0){
+            *max_slots = q->quantum - q->slots_used[job_index];
+        }
+        return job_index;
+    }
+
+    //A job that was stopped part way through its slice finishes it before anyone else is looked at
+    if(q->held->length > 0){
+        size_t job_index = min_heap_pop(q->held).index;
+        *max_slots = q->slice_left[job_index];
+        return job_index;
+    }
+
+    //The person furthest behind goes next, and runs their shortest job
+    drop_stale_people(q);
+    size_t person = min_heap_pop(q->people).index;
+    q->person_queued[person] = 0;
+    q->system_virtual_time = q->virtual_times[person];
+    size_t job_index = min_heap_pop(q->person_jobs[person]).index;
+
+    //They get the CPU until they've caught up to and just passed the next person in line, but for at least a slice
+    size_t slice = q->quantum;
+    if(slice == 0){
+        slice = table->durations[job_index] / FAIR_SHARE_SLICES_PER_JOB;
+        if(slice == 0){
+            slice = 1;
+        }
+    }
+    q->slice_left[job_index] = slice;
+    drop_stale_people(q);
+    if(q->people->length == 0){
+        *max_slots = SIZE_MAX;
+    }else{
+        size_t next_virtual_time = q->people->entries[0].key;
+        *max_slots = (next_virtual_time - q->virtual_times[person]) / q->virtual_time_per_slot[person] + 1;
+        if(*max_slots < slice){
+            *max_slots = slice;
+        }
+    }
+
+    //If they have more waiting, they stay in line in case there's another CPU free
+    if(q->person_jobs[person]->length > 0){
+        min_heap_push(q->people, q->virtual_times[person], person);
+        q->person_queued[person] = 1;
+    }
+
+    return job_index;
+}
+
+void ready_queue_return(ready_queue* q, job_table* table, size_t job_index, size_t ran_for, size_t remaining){
+    if(q->policy == POLICY_EDF){
+        size_t deadline = table->deadlines[job_index];
+        if(deadline != NO_DEADLINE && ran_for > 0){
+            admission_tree_set_work(q->admission, job_index, remaining);
+        }
+    }
+
+    if(q->policy != POLICY_FAIR_SHARE){
+        if(q->policy == POLICY_ROUND_ROBIN){
+            //Only a job that used up its quantum goes to the back of the line. One that was stopped by an arrival or
+            // a completion keeps its ticket and the rest of its quantum
+            q->slots_used[job_index] += ran_for;
+            if(q->quantum > 0 && q->slots_used[job_index] >= q->quantum){
+                q->tickets[job_index] = q->next_ticket++;
+                q->slots_used[job_index] = 0;
+            }
+        }
+        if(remaining > 0){
+            q->length++;
+            min_heap_push(q->jobs, ready_queue_job_key(q, table, job_index, remaining), job_index);
+        }
+        return;
+    }
+
+    size_t person = table->person_ids[job_index];
+    if(ran_for > 0){
+        set_virtual_time(q, person, q->virtual_times[person] + ran_for * q->virtual_time_per_slot[person]);
+    }
+    if(remaining > 0 && ran_for < q->slice_left[job_index]){
+        //Something other than the end of its slice stopped it, so it keeps the rest of the slice
+        q->slice_left[job_index] -= ran_for;
+        q->length++;
+        min_heap_push(q->held, job_index, job_index);
+    }else if(remaining > 0){
+        q->length++;
+        min_heap_push(q->person_jobs[person], remaining, job_index);
+    }
+    //Their virtual time moved, so any entry they had is out of date now
+    if(q->person_jobs[person]->length > 0 && (ran_for > 0 || !q->person_queued[person])){
+        min_heap_push(q->people, q->virtual_times[person], person);
+        q->person_queued[person] = 1;
+    }
+}
+
+void destroy_ready_queue(ready_queue* q){
+    if(q->jobs != NULL){
+        destroy_min_heap(q->jobs);
+    }
+    if(q->admission != NULL){
+        destroy_admission_tree(q->admission);
+    }
+    if(q->people != NULL){
+        destroy_min_heap(q->people);
+    }
+    if(q->held != NULL){
+        destroy_min_heap(q->held);
+    }
+    if(q->person_jobs != NULL){
+        size_t i;
+        for(i = 0; i < q->num_people; i++){
+            if(q->person_jobs[i] != NULL){
+                destroy_min_heap(q->person_jobs[i]);
+            }
+        }
+    }
+    free(q->person_jobs);
+    free(q->virtual_times);
+    free(q->virtual_time_per_slot);
+    free(q->person_queued);
+    free(q->tickets);
+    free(q->slots_used);
+    free(q->slice_left);
+    free(q->changes);
+    free(q);
+}
+
+/**
+ * Orders arrivals by time, then by job index so jobs that arrive together stay in the order they were read
+ */
+static int compare_arrivals(const void* a_v, const void* b_v){
+    const arrival* a = (const arrival*)a_v;
+    const arrival* b = (const arrival*)b_v;
+    if(a->time != b->time){
+        return a->time < b->time ? -1 : 1;
+    }
+    if(a->job_index != b->job_index){
+        return a->job_index < b->job_index ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Marks a job as rejected, along with everything that depends on it (directly or not), since they can never start now.
+ * stack needs room for every job.
+ * Returns how many jobs were newly rejected
+ */
+static size_t reject_job(schedule* s, job_table* table, dependency_graph* graph, size_t job_index, size_t* stack, trace_writer* trace, size_t time){
+    size_t num_rejected = 0;
+    size_t stack_length = 0;
+    size_t k;
+    s->rejected[job_index] = 1;
+    stack[stack_length++] = job_index;
+    while(stack_length > 0){
+        size_t curr = stack[--stack_length];
+        num_rejected++;
+        if(trace != NULL){
+            trace_job_event(trace, table, "Rejected", curr, SIZE_MAX, time);
+        }
+        if(graph == NULL){
+            continue;
+        }
+        for(k = graph->dependent_offsets[curr]; k < graph->dependent_offsets[curr + 1]; k++){
+            size_t dependent = graph->dependents[k];
+            if(!s->rejected[dependent]){
+                s->rejected[dependent] = 1;
+                stack[stack_length++] = dependent;
+            }
+        }
+    }
+    s->num_rejected += num_rejected;
+    return num_rejected;
+}
+
+/**
+ * Sets up the per job state for jobs from up to the table's length, other than where they go in the arrivals
+ */
+static void start_jobs(scheduler* sch, size_t from){
+    size_t i;
+    for(i = from; i < sch->table->length; i++){
+        sch->remaining[i] = sch->table->durations[i];
+        sch->unmet[i] = sch->graph == NULL ? 0 : sch->graph->num_unmet[i];
+        sch->arrived[i] = 0;
+        sch->last_cpu[i] = SIZE_MAX;
+        if(sch->picked_at != NULL){
+            sch->picked_at[i] = SIZE_MAX;
+        }
+        if(sch->resumable){
+            sch->s->completion_times[i] = SIZE_MAX;
+        }
+    }
+}
+
+scheduler* create_scheduler(job_table* table, dependency_graph* graph, scheduler_config* config, int resumable){
+    size_t n = table->length;
+    size_t num_cpus = config->num_cpus;
+
+    scheduler* sch = (scheduler*)calloc(1, sizeof(scheduler));
+    if(sch == NULL){
+        fprintf(stderr, "ERROR in create_scheduler() : Could not allocate space for scheduler struct\n");
+        exit(EXIT_FAILURE);
+    }
+    sch->table = table;
+    sch->graph = graph;
+    sch->config = config;
+    sch->num_jobs = n;
+    sch->jobs_capacity = n;
+    sch->resumable = resumable;
+    sch->rewind_to = SIZE_MAX;
+    sch->last_waiting = SIZE_MAX;
+    sch->last_running = SIZE_MAX;
+
+    sch->s = create_schedule(n, num_cpus);
+    sch->ready = create_ready_queue(table, config);
+    sch->ready->keeping_changes = resumable;
+    sch->remaining = (size_t*)malloc((n + 1) * sizeof(size_t));
+    sch->unmet = (size_t*)malloc((n + 1) * sizeof(size_t));
+    sch->arrived = (char*)malloc((n + 1) * sizeof(char));
+    sch->arrivals = (arrival*)malloc((n + 1) * sizeof(arrival));
+    sch->reject_stack = (size_t*)malloc((n + 1) * sizeof(size_t));
+    sch->last_cpu = (size_t*)malloc((n + 1) * sizeof(size_t));
+    sch->picked = (size_t*)malloc(num_cpus * sizeof(size_t));
+    sch->picked_cpu = (size_t*)malloc(num_cpus * sizeof(size_t));
+    sch->cpu_taken = (char*)malloc(num_cpus * sizeof(char));
+    if(sch->s == NULL || sch->remaining == NULL || sch->unmet == NULL || sch->arrived == NULL || sch->arrivals == NULL
+        || sch->reject_stack == NULL || sch->last_cpu == NULL || sch->picked == NULL || sch->picked_cpu == NULL || sch->cpu_taken == NULL){
+        fprintf(stderr, "ERROR in create_scheduler() : Could not allocate space for scheduler state\n");
+        exit(EXIT_FAILURE);
+    }
+    if(config->trace != NULL){
+        sch->picked_at = (size_t*)malloc((n + 1) * sizeof(size_t));
+        sch->prev_picked = (size_t*)malloc(num_cpus * sizeof(size_t));
+        if(sch->picked_at == NULL || sch->prev_picked == NULL){
+            fprintf(stderr, "ERROR in create_scheduler() : Could not allocate space for trace state\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    size_t i;
+    start_jobs(sch, 0);
+    for(i = 0; i < n; i++){
+        sch->arrivals[i].time = table->arrival_times[i];
+        sch->arrivals[i].job_index = i;
+    }
+    qsort(sch->arrivals, n, sizeof(arrival), compare_arrivals);
+
+    return sch;
+}
+
+/**
+ * Notes down a checkpoint at the top of the loop, unless there's already one for this time
+ */
+static void add_checkpoint(scheduler* sch, size_t time, size_t next_arrival, size_t num_completed){
+    if(sch->num_checkpoints > 0 && sch->checkpoints[sch->num_checkpoints - 1].time == time){
+        return;
+    }
+    if(sch->num_checkpoints == sch->checkpoints_capacity){
+        sch->checkpoints_capacity = sch->checkpoints_capacity == 0 ? 64 : sch->checkpoints_capacity * 2;
+        sch->checkpoints = (scheduler_checkpoint*)grow_scheduler_array(sch->checkpoints, sch->checkpoints_capacity, sizeof(scheduler_checkpoint));
+    }
+    scheduler_checkpoint* cp = &sch->checkpoints[sch->num_checkpoints];
+    cp->time = time;
+    cp->next_arrival = next_arrival;
+    cp->num_completed = num_completed;
+    cp->num_runs = sch->s->num_runs;
+    cp->num_rejected = sch->s->num_rejected;
+    cp->makespan = sch->s->makespan;
+    cp->next_ticket = sch->ready->next_ticket;
+    cp->system_virtual_time = sch->ready->system_virtual_time;
+    cp->num_changes = sch->ready->num_changes;
+    sch->num_checkpoints++;
+}
+
+/**
+ * Goes back to the last checkpoint at or before rewind_to, or all the way back to the start if there isn't one,
+ *  and undoes everything that happened to the jobs arriving from there on
+ */
+static void rewind_scheduler(scheduler* sch){
+    scheduler_checkpoint cp;
+    memset(&cp, 0, sizeof(scheduler_checkpoint));
+    size_t low = 0;
+    size_t high = sch->num_checkpoints;
+    while(low < high){
+        size_t mid = low + (high - low) / 2;
+        if(sch->checkpoints[mid].time <= sch->rewind_to){
+            low = mid + 1;
+        }else{
+            high = mid;
+        }
+    }
+    if(low > 0){
+        cp = sch->checkpoints[low - 1];
+    }
+    sch->num_checkpoints = low;
+    sch->rewind_to = SIZE_MAX;
+
+    schedule* s = sch->s;
+    size_t k;
+    for(k = cp.next_arrival; k < sch->num_jobs; k++){
+        size_t job_index = sch->arrivals[k].job_index;
+        sch->remaining[job_index] = sch->table->durations[job_index];
+        sch->arrived[job_index] = 0;
+        sch->last_cpu[job_index] = SIZE_MAX;
+        s->completion_times[job_index] = SIZE_MAX;
+        s->rejected[job_index] = 0;
+    }
+    //Every job that ran before the checkpoint had finished by then, so no run can be extended past it
+    s->num_runs = cp.num_runs;
+    s->num_rejected = cp.num_rejected;
+    s->makespan = cp.makespan;
+    for(k = 0; k < s->num_cpus; k++){
+        s->last_run_on_cpu[k] = SIZE_MAX;
+    }
+    ready_queue_rewind(sch->ready, cp.next_ticket, cp.system_virtual_time, cp.num_changes);
+    sch->time = cp.time;
+    sch->next_arrival = cp.next_arrival;
+    sch->num_completed = cp.num_completed;
+    sch->arrivals_through = cp.time;
+}
+
+int run_scheduler(scheduler* sch, size_t max_events){
+    if(sch->rewind_to != SIZE_MAX){
+        rewind_scheduler(sch);
+    }
+
+    //Everything the loop touches is copied out so the compiler can keep it in registers
+    job_table* table = sch->table;
+    dependency_graph* graph = sch->graph;
+    scheduler_config* config = sch->config;
+    schedule* s = sch->s;
+    ready_queue* ready = sch->ready;
+    size_t n = sch->num_jobs;
+    size_t num_cpus = config->num_cpus;
+    size_t* remaining = sch->remaining;
+    size_t* unmet = sch->unmet;
+    char* arrived = sch->arrived;
+    arrival* arrivals = sch->arrivals;
+    size_t* last_cpu = sch->last_cpu;
+    size_t* picked = sch->picked;
+    size_t* picked_cpu = sch->picked_cpu;
+    char* cpu_taken = sch->cpu_taken;
+    trace_writer* trace = config->trace;
+    size_t* picked_at = sch->picked_at;
+    size_t* prev_picked = sch->prev_picked;
+    size_t num_prev_picked = sch->num_prev_picked;
+    size_t last_waiting = sch->last_waiting;
+    size_t last_running = sch->last_running;
+    size_t time = sch->time;
+    size_t next_arrival = sch->next_arrival;
+    size_t num_completed = sch->num_completed;
+    size_t arrivals_through = sch->arrivals_through;
+
+    size_t i, k, c;
+    size_t num_events = 0;
+    while(num_completed < n && num_events < max_events){
+        num_events++;
+        //Jobs that take no time can finish without time moving on, so the loop can come back round to a time it has
+        // already picked jobs at. That's no good as a checkpoint, since a job arriving then should have been there
+        if(sch->resumable && ready->length == 0 && (sch->num_checkpoints == 0 || arrivals_through < time)){
+            add_checkpoint(sch, time, next_arrival, num_completed);
+        }
+
+        //Everything that has shown up by now joins the ready queue, unless it's still waiting on a prerequisite.
+        // Those join when their last prerequisite completes instead.
+        while(next_arrival < n && arrivals[next_arrival].time <= time){
+            size_t arriving = arrivals[next_arrival].job_index;
+            arrived[arriving] = 1;
+            if(trace != NULL){
+                trace_job_event(trace, table, "Arrived", arriving, SIZE_MAX, time);
+            }
+            s->ready_times[arriving] = time;
+            if(unmet[arriving] == 0 && ready_queue_push(ready, table, arriving, remaining[arriving], time) != 0){
+                //Admission control says it can't make its deadline, so it never runs
+                num_completed += reject_job(s, table, graph, arriving, sch->reject_stack, trace, time);
+            }
+            next_arrival++;
+        }
+        arrivals_through = time;
+
+        if(ready->length == 0){
+            if(trace != NULL){
+                trace_queue_depth(trace, time, 0, 0);
+                last_waiting = 0;
+                last_running = 0;
+                num_prev_picked = 0;
+            }
+            if(num_completed == n){
+                //The last jobs to show up were all rejected
+                break;
+            }
+            if(next_arrival == n){
+                //build_dependency_graph() rules out cycles, so this can't happen
+                fprintf(stderr, "ERROR in run_scheduler() : Jobs are left waiting on prerequisites that will never complete\n");
+                exit(EXIT_FAILURE);
+            }
+            //CPUs sit idle until the next job shows up
+            time = arrivals[next_arrival].time;
+            continue;
+        }
+
+        //Fill as many CPUs as there are ready jobs for. They all run until the first of them finishes or uses up its
+        // share or quantum, or somebody new arrives who might go first
+        size_t num_picked = 0;
+        size_t end = next_arrival < n ? arrivals[next_arrival].time : SIZE_MAX;
+        while(num_picked < num_cpus && ready->length > 0){
+            size_t max_slots;
+            size_t running = ready_queue_pop(ready, table, &max_slots);
+            //Fair share already uses the quantum as its slice length
+            if(config->policy != POLICY_FAIR_SHARE && config->quantum > 0 && config->quantum < max_slots){
+                max_slots = config->quantum;
+            }
+            if(remaining[running] < max_slots){
+                max_slots = remaining[running];
+            }
+            if(time + max_slots < end){
+                end = time + max_slots;
+            }
+            picked[num_picked] = running;
+            num_picked++;
+        }
+
+        if(trace != NULL){
+            for(i = 0; i < num_picked; i++){
+                picked_at[picked[i]] = time;
+            }
+            for(i = 0; i < num_prev_picked; i++){
+                if(remaining[prev_picked[i]] > 0 && picked_at[prev_picked[i]] != time){
+                    trace_job_event(trace, table, "Preempted", prev_picked[i], last_cpu[prev_picked[i]], time);
+                }
+            }
+            memcpy(prev_picked, picked, num_picked * sizeof(size_t));
+            num_prev_picked = num_picked;
+            if(ready->length != last_waiting || num_picked != last_running){
+                trace_queue_depth(trace, time, ready->length, num_picked);
+                last_waiting = ready->length;
+                last_running = num_picked;
+            }
+        }
+
+        //Jobs stay on the CPU they were on last if it's free, the rest take whichever CPUs are left
+        memset(cpu_taken, 0, num_cpus * sizeof(char));
+        for(i = 0; i < num_picked; i++){
+            picked_cpu[i] = SIZE_MAX;
+            c = last_cpu[picked[i]];
+            if(c != SIZE_MAX && !cpu_taken[c]){
+                picked_cpu[i] = c;
+                cpu_taken[c] = 1;
+            }
+        }
+        c = 0;
+        for(i = 0; i < num_picked; i++){
+            if(picked_cpu[i] == SIZE_MAX){
+                while(cpu_taken[c]){
+                    c++;
+                }
+                picked_cpu[i] = c;
+                cpu_taken[c] = 1;
+            }
+            last_cpu[picked[i]] = picked_cpu[i];
+            add_run_to_schedule(s, picked[i], picked_cpu[i], time, end);
+            remaining[picked[i]] -= end - time;
+            ready_queue_return(ready, table, picked[i], end - time, remaining[picked[i]]);
+        }
+        time = end;
+
+        for(i = 0; i < num_picked; i++){
+            size_t running = picked[i];
+            if(remaining[running] > 0){
+                continue;
+            }
+
+            s->completion_times[running] = time;
+            s->makespan = time;
+            num_completed++;
+            if(trace != NULL){
+                trace_job_event(trace, table, "Completed", running, last_cpu[running], time);
+            }
+            if(graph == NULL){
+                continue;
+            }
+            for(k = graph->dependent_offsets[running]; k < graph->dependent_offsets[running + 1]; k++){
+                size_t dependent = graph->dependents[k];
+                unmet[dependent]--;
+                if(unmet[dependent] == 0){
+                    s->ready_times[dependent] = time;
+                }
+                if(unmet[dependent] == 0 && arrived[dependent] && ready_queue_push(ready, table, dependent, remaining[dependent], time) != 0){
+                    num_completed += reject_job(s, table, graph, dependent, sch->reject_stack, trace, time);
+                }
+            }
+        }
+    }
+
+    sch->num_prev_picked = num_prev_picked;
+    sch->last_waiting = last_waiting;
+    sch->last_running = last_running;
+    sch->time = time;
+    sch->next_arrival = next_arrival;
+    sch->num_completed = num_completed;
+    sch->arrivals_through = arrivals_through;
+    return num_completed == n;
+}
+
+void scheduler_add_jobs(scheduler* sch){
+    size_t old_n = sch->num_jobs;
+    size_t n = sch->table->length;
+    if(n == old_n){
+        return;
+    }
+    if(n > sch->jobs_capacity){
+        size_t new_capacity = sch->jobs_capacity * 2 < n ? n : sch->jobs_capacity * 2;
+        sch->remaining = (size_t*)grow_scheduler_array(sch->remaining, new_capacity, sizeof(size_t));
+        sch->unmet = (size_t*)grow_scheduler_array(sch->unmet, new_capacity, sizeof(size_t));
+        sch->arrived = (char*)grow_scheduler_array(sch->arrived, new_capacity, sizeof(char));
+        sch->arrivals = (arrival*)grow_scheduler_array(sch->arrivals, new_capacity, sizeof(arrival));
+        sch->reject_stack = (size_t*)grow_scheduler_array(sch->reject_stack, new_capacity, sizeof(size_t));
+        sch->last_cpu = (size_t*)grow_scheduler_array(sch->last_cpu, new_capacity, sizeof(size_t));
+        grow_schedule(sch->s, sch->jobs_capacity, new_capacity);
+        sch->jobs_capacity = new_capacity;
+    }
+    ready_queue_add_jobs(sch->ready, sch->table);
+    start_jobs(sch, old_n);
+
+    //The new jobs are sorted on their own and merged in from the back. They all have bigger indexes, so they go after
+    // any old job arriving at the same time, and only old jobs arriving later than them have to move.
+    arrival* added = sch->arrivals + old_n;
+    size_t num_added = n - old_n;
+    size_t i;
+    for(i = 0; i < num_added; i++){
+        added[i].time = sch->table->arrival_times[old_n + i];
+        added[i].job_index = old_n + i;
+    }
+    qsort(added, num_added, sizeof(arrival), compare_arrivals);
+    arrival* merged = (arrival*)malloc(num_added * sizeof(arrival));
+    if(merged == NULL){
+        fprintf(stderr, "ERROR in scheduler_add_jobs() : Could not allocate space for arrivals\n");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(merged, added, num_added * sizeof(arrival));
+    size_t old_k = old_n;
+    size_t new_k = num_added;
+    size_t to = n;
+    while(new_k > 0){
+        if(old_k > 0 && sch->arrivals[old_k - 1].time > merged[new_k - 1].time){
+            sch->arrivals[--to] = sch->arrivals[--old_k];
+        }else{
+            sch->arrivals[--to] = merged[--new_k];
+        }
+    }
+
+    //A job arriving at or after the time the scheduler has got up to just joins the arrivals, unless jobs have already
+    // been picked at that time. Anything earlier means going back
+    if(merged[0].time < sch->time || (merged[0].time <= sch->arrivals_through && sch->num_checkpoints > 0)){
+        if(merged[0].time < sch->rewind_to){
+            sch->rewind_to = merged[0].time;
+        }
+    }
+    free(merged);
+    sch->num_jobs = n;
+}
+
+schedule* finish_scheduler(scheduler* sch){
+    if(sch->config->trace != NULL && sch->last_running != 0){
+        //Everything is done, so the queue empties out
+        trace_queue_depth(sch->config->trace, sch->time, 0, 0);
+    }
+
+    schedule* s = sch->s;
+    free(sch->checkpoints);
+    free(sch->prev_picked);
+    free(sch->picked_at);
+    free(sch->cpu_taken);
+    free(sch->picked_cpu);
+    free(sch->picked);
+    free(sch->last_cpu);
+    free(sch->reject_stack);
+    free(sch->arrivals);
+    free(sch->arrived);
+    free(sch->unmet);
+    free(sch->remaining);
+    destroy_ready_queue(sch->ready);
+    free(sch);
+    return s;
+}
+
+schedule* schedule_jobs(job_table* table, dependency_graph* graph, scheduler_config* config){
+    scheduler* sch = create_scheduler(table, graph, config, 0);
+    run_scheduler(sch, SIZE_MAX);
+    return finish_scheduler(sch);
+}
+
+//-----------------------OUTPUT IMPLEMENTATIONS-----------------------//
+
+/**
+ * Something that changes how many CPUs are busy (a run starting or ending) or whether a person has work to do (one of
+ *  their jobs becoming ready or completing)
+ */
+typedef struct share_event{
+    size_t time;
+    size_t person; //SIZE_MAX for a run starting or ending
+    int change; //+1 or -1
+} share_event;
+
+static int compare_share_events(const void* a_v, const void* b_v){
+    const share_event* a = (const share_event*)a_v;
+    const share_event* b = (const share_event*)b_v;
+    if(a->time != b->time){
+        return a->time < b->time ? -1 : 1;
+    }
+    return 0;
+}
+
+/**
+ * Works out each person's fair share over the time they were competing for a CPU, from their first ready job to their
+ *  last completion with any gaps where they had nothing to do left out. contended gets the CPU time everyone used
+ *  while they were competing, entitled the part of that their weight entitled them to against whoever else was.
+ * Both are indexed by person_id
+ */
+static void measure_fair_shares(schedule* s, job_table* table, scheduler_config* config, double* contended, double* entitled){
+    size_t num_people = table->num_people;
+    size_t num_events = 2 * (s->num_runs + table->length);
+    share_event* events = (share_event*)malloc((num_events + 1) * sizeof(share_event));
+    size_t* num_active = (size_t*)calloc(num_people + 1, sizeof(size_t));
+    double* busy_at_start = (double*)malloc((num_people + 1) * sizeof(double)); //busy so far when they started competing
+    double* entitled_at_start = (double*)malloc((num_people + 1) * sizeof(double)); //same for entitled_per_weight
+    if(events == NULL || num_active == NULL || busy_at_start == NULL || entitled_at_start == NULL){
+        fprintf(stderr, "ERROR in measure_fair_shares() : Could not allocate space for fair shares\n");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t e = 0;
+    size_t i;
+    for(i = 0; i < s->num_runs; i++){
+        events[e].time = s->runs[i].start;
+        events[e].person = SIZE_MAX;
+        events[e].change = 1;
+        e++;
+        events[e].time = s->runs[i].end;
+        events[e].person = SIZE_MAX;
+        events[e].change = -1;
+        e++;
+    }
+    for(i = 0; i < table->length; i++){
+        if(s->rejected[i]){
+            continue;
+        }
+        events[e].time = s->ready_times[i];
+        events[e].person = table->person_ids[i];
+        events[e].change = 1;
+        e++;
+        events[e].time = s->completion_times[i];
+        events[e].person = table->person_ids[i];
+        events[e].change = -1;
+        e++;
+    }
+    num_events = e;
+    qsort(events, num_events, sizeof(share_event), compare_share_events);
+
+    //Running totals over the whole schedule, so a person only needs them read when they start and stop competing:
+    // busy is CPU time used, entitled_per_weight is CPU time used divided by the total weight of everyone competing
+    double busy = 0.0;
+    double entitled_per_weight = 0.0;
+    size_t num_busy = 0;
+    size_t total_weight = 0;
+    size_t last_time = num_events > 0 ? events[0].time : 0;
+    for(e = 0; e < num_events; e++){
+        if(events[e].time > last_time && total_weight > 0){
+            double used = (double)num_busy * (double)(events[e].time - last_time);
+            busy += used;
+            entitled_per_weight += used / (double)total_weight;
+        }
+        last_time = events[e].time;
+
+        size_t person = events[e].person;
+        if(person == SIZE_MAX){
+            num_busy += events[e].change;
+            continue;
+        }
+        size_t weight = config->weights == NULL ? DEFAULT_WEIGHT : config->weights[person];
+        if(events[e].change > 0){
+            if(num_active[person] == 0){
+                busy_at_start[person] = busy;
+                entitled_at_start[person] = entitled_per_weight;
+                total_weight += weight;
+            }
+            num_active[person]++;
+        }else{
+            num_active[person]--;
+            if(num_active[person] == 0){
+                contended[person] += busy - busy_at_start[person];
+                entitled[person] += (double)weight * (entitled_per_weight - entitled_at_start[person]);
+                total_weight -= weight;
+            }
+        }
+    }
+
+    free(entitled_at_start);
+    free(busy_at_start);
+    free(num_active);
+    free(events);
+}
+
+void print_output(schedule* s, job_table* table, scheduler_config* config){
+    size_t index = s->num_runs > 0 ? s->runs[0].start : 0;
+    size_t r;
+    if(s->num_cpus == 1){
+        //Print header
+        fprintf(stdout, "Time\tJob\n");
+
+        //Print out every time slot from the start of the first run to the end, filling the gaps between runs with IDLE
+        for(r = 0; r < s->num_runs; r++){
+            run* curr_run = &s->runs[r];
+            while(index < curr_run->start){
+                fprintf(stdout, "%zu\t\t%s\n", index, IDLE_JOB_NAME);
+                index++;
+            }
+            char* job_name = get_job_name(table, curr_run->job_index);
+            while(index < curr_run->end){
+                fprintf(stdout, "%zu\t\t%s\n", index, job_name);
+                index++;
+            }
+        }
+        //Once everything is done the CPU goes idle
+        fprintf(stdout, "%zu\t\t%s\n", index, IDLE_JOB_NAME);
+    }else{
+        //One column per CPU
+        fprintf(stdout, "Time");
+        size_t c;
+        for(c = 0; c < s->num_cpus; c++){
+            fprintf(stdout, "\tCPU %zu", c);
+        }
+        fprintf(stdout, "\n");
+
+        //Each CPU keeps its own place in the list of runs. A CPU's runs are in the order they started, so the
+        // place only ever moves forward
+        size_t* cursor = (size_t*)calloc(s->num_cpus, sizeof(size_t));
+        if(cursor == NULL){
+            fprintf(stderr, "ERROR in print_output : Could not allocate space for CPU columns\n");
+            exit(EXIT_FAILURE);
+        }
+        for(; index <= s->makespan; index++){
+            fprintf(stdout, "%zu", index);
+            for(c = 0; c < s->num_cpus; c++){
+                while(cursor[c] < s->num_runs && (s->runs[cursor[c]].cpu != c || s->runs[cursor[c]].end <= index)){
+                    cursor[c]++;
+                }
+                if(cursor[c] < s->num_runs && s->runs[cursor[c]].start <= index){
+                    fprintf(stdout, "\t%s", get_job_name(table, s->runs[cursor[c]].job_index));
+                }else{
+                    fprintf(stdout, "\t%s", IDLE_JOB_NAME);
+                }
+            }
+            fprintf(stdout, "\n");
+        }
+        free(cursor);
+    }
+
+    //Now print out summary header
+    fprintf(stdout, "\nSummary\n");
+
+    //Find when each person's latest job finished. People are listed in the order they first showed up
+    size_t num_people = table->num_people;
+    size_t* latest_completion = (size_t*)calloc(num_people + 1, sizeof(size_t));
+    char* has_completed = (char*)calloc(num_people + 1, sizeof(char));
+    size_t* cpu_time = (size_t*)calloc(num_people + 1, sizeof(size_t));
+    double* contended = (double*)calloc(num_people + 1, sizeof(double));
+    double* entitled = (double*)calloc(num_people + 1, sizeof(double));
+    size_t* missed_offsets = (size_t*)calloc(num_people + 2, sizeof(size_t));
+    if(latest_completion == NULL || has_completed == NULL || cpu_time == NULL || contended == NULL || entitled == NULL || missed_offsets == NULL){
+        fprintf(stderr, "ERROR in print_output : Could not allocate space for summary\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t i;
+    size_t num_missed = 0;
+    for(i = 0; i < table->length; i++){
+        size_t person = table->person_ids[i];
+        if(s->rejected[i] || (table->deadlines[i] != NO_DEADLINE && s->completion_times[i] > table->deadlines[i])){
+            missed_offsets[person + 2]++;
+            num_missed++;
+        }
+        if(s->rejected[i]){
+            continue;
+        }
+        has_completed[person] = 1;
+        if(s->completion_times[i] > latest_completion[person]){
+            latest_completion[person] = s->completion_times[i];
+        }
+    }
+
+    //Group the jobs that were rejected or finished late by person, so they can be listed next to them
+    size_t* missed = (size_t*)malloc((num_missed + 1) * sizeof(size_t));
+    if(missed == NULL){
+        fprintf(stderr, "ERROR in print_output : Could not allocate space for late and rejected jobs\n");
+        exit(EXIT_FAILURE);
+    }
+    for(i = 0; i < num_people; i++){
+        missed_offsets[i + 2] += missed_offsets[i + 1];
+    }
+    for(i = 0; i < table->length && num_missed > 0; i++){
+        if(s->rejected[i] || (table->deadlines[i] != NO_DEADLINE && s->completion_times[i] > table->deadlines[i])){
+            missed[missed_offsets[table->person_ids[i] + 1]++] = i;
+        }
+    }
+
+    //Add up how much CPU time each person got, and how much was going while they were competing for it. Over the
+    // whole schedule every policy hands out the same total, it's only while people are waiting on each other that
+    // fair share makes a difference
+    if(config->policy == POLICY_FAIR_SHARE){
+        for(r = 0; r < s->num_runs; r++){
+            cpu_time[table->person_ids[s->runs[r].job_index]] += s->runs[r].end - s->runs[r].start;
+        }
+        measure_fair_shares(s, table, config, contended, entitled);
+    }
+
+    //Now print out some stuff
+    for(i = 0; i < num_people; i++){
+        if(has_completed[i]){
+            fprintf(stdout, "%s \t%zu", get_person_name(table, i), latest_completion[i]);
+        }else{
+            //Every one of their jobs was rejected, so nothing of theirs ever finished
+            fprintf(stdout, "%s \t-", get_person_name(table, i));
+        }
+
+        if(config->policy == POLICY_FAIR_SHARE){
+            if(contended[i] > 0.0){
+                fprintf(stdout, "\t%.1f%% (fair %.1f%%)", 100.0 * (double)cpu_time[i] / contended[i], 100.0 * entitled[i] / contended[i]);
+            }else{
+                fprintf(stdout, "\t-");
+            }
+        }
+
+        int pass;
+        for(pass = 0; pass < 2; pass++){
+            //First pass lists the late jobs, second the rejected ones
+            char* label = pass == 0 ? "late" : "rejected";
+            size_t num_listed = 0;
+            size_t k;
+            for(k = missed_offsets[i]; k < missed_offsets[i + 1]; k++){
+                if(s->rejected[missed[k]] != pass){
+                    continue;
+                }
+                if(num_listed == 0){
+                    fprintf(stdout, "\t%s: %s", label, get_job_name(table, missed[k]));
+                }else{
+                    fprintf(stdout, ",%s", get_job_name(table, missed[k]));
+                }
+                num_listed++;
+            }
+        }
+        fprintf(stdout, "\n");
+    }
+
+    free(missed);
+    free(missed_offsets);
+    free(entitled);
+    free(contended);
+    free(cpu_time);
+    free(has_completed);
+    free(latest_completion);
+}
+
+//-----------------------OPTIONS IMPLEMENTATIONS-----------------------//
+
+/**
+ * Policy names as they're written on the command line, indexed by scheduling_policy
+ */
+static char* policy_names[] = {"sjf", "fair", "edf", "rr"};
+
+static void parse_policy_list(char* value, options* opts, char* program_name){
+    free(opts->policies);
+    opts->policies = NULL;
+    opts->num_policies = 0;
+
+    char* rest = NULL;
+    char* name = strtok_r(value, ",", &rest);
+    while(name != NULL){
+        size_t p;
+        size_t num_names = sizeof(policy_names) / sizeof(policy_names[0]);
+        for(p = 0; p < num_names && strcmp(name, policy_names[p]) != 0; p++);
+        if(p == num_names){
+            fprintf(stderr, "ERROR in parse_policy_list() : Unknown policy %s\n", name);
+            print_usage(stderr, program_name);
+            exit(EXIT_FAILURE);
+        }
+
+        void* policies_v = realloc(opts->policies, (opts->num_policies + 1) * sizeof(scheduling_policy));
+        if(policies_v == NULL){
+            fprintf(stderr, "ERROR in parse_policy_list() : Could not allocate space for policy list\n");
+            exit(EXIT_FAILURE);
+        }
+        opts->policies = (scheduling_policy*)policies_v;
+        opts->policies[opts->num_policies] = (scheduling_policy)p;
+        opts->num_policies++;
+        name = strtok_r(NULL, ",", &rest);
+    }
+}
+
+/**
+ * Splits a comma separated list of numbers like "1,2,4" into a newly allocated list, replacing the old one
+ */
+static void parse_size_list(char* value, size_t** list, size_t* length){
+    free(*list);
+    *list = NULL;
+    *length = 0;
+
+    char* rest = NULL;
+    char* number = strtok_r(value, ",", &rest);
+    while(number != NULL){
+        void* list_v = realloc(*list, (*length + 1) * sizeof(size_t));
+        if(list_v == NULL){
+            fprintf(stderr, "ERROR in parse_size_list() : Could not allocate space for option list\n");
+            exit(EXIT_FAILURE);
+        }
+        *list = (size_t*)list_v;
+        (*list)[*length] = strtosizet(number);
+        (*length)++;
+        number = strtok_r(NULL, ",", &rest);
+    }
+}
+
+void parse_options(int argc, char** argv, options* opts){
+    opts->policies = NULL;
+    opts->num_policies = 0;
+    opts->cpu_counts = NULL;
+    opts->num_cpu_counts = 0;
+    opts->quanta = NULL;
+    opts->num_quanta = 0;
+    opts->weights_path = NULL;
+    opts->trace_path = NULL;
+    opts->sweep = 0;
+    opts->num_threads = 0;
+    opts->summary_path = NULL;
+    opts->num_merge_paths = 0;
+    opts->merge = 0;
+    opts->serve_path = NULL;
+    opts->client_path = NULL;
+    opts->merge_paths = (char**)malloc(argc * sizeof(char*));
+    if(opts->merge_paths == NULL){
+        fprintf(stderr, "ERROR in parse_options() : Could not allocate space for summary file list\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int i;
+    for(i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--policy") == 0 && i + 1 < argc){
+            i++;
+            parse_policy_list(argv[i], opts, argv[0]);
+        }else if(strcmp(argv[i], "--cpus") == 0 && i + 1 < argc){
+            i++;
+            parse_size_list(argv[i], &opts->cpu_counts, &opts->num_cpu_counts);
+        }else if(strcmp(argv[i], "--quantum") == 0 && i + 1 < argc){
+            i++;
+            parse_size_list(argv[i], &opts->quanta, &opts->num_quanta);
+        }else if(strcmp(argv[i], "--weights") == 0 && i + 1 < argc){
+            i++;
+            opts->weights_path = argv[i];
+        }else if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc){
+            i++;
+            opts->trace_path = argv[i];
+        }else if(strcmp(argv[i], "--sweep") == 0){
+            opts->sweep = 1;
+        }else if(strcmp(argv[i], "--threads") == 0 && i + 1 < argc){
+            i++;
+            opts->num_threads = strtosizet(argv[i]);
+        }else if(strcmp(argv[i], "--summary-out") == 0 && i + 1 < argc){
+            i++;
+            opts->summary_path = argv[i];
+        }else if(strcmp(argv[i], "--merge-summaries") == 0){
+            opts->merge = 1;
+        }else if(strcmp(argv[i], "--serve") == 0 && i + 1 < argc){
+            i++;
+            opts->serve_path = argv[i];
+        }else if(strcmp(argv[i], "--client") == 0 && i + 1 < argc){
+            i++;
+            opts->client_path = argv[i];
+        }else if(strcmp(argv[i], "--help") == 0){
+            print_usage(stdout, argv[0]);
+            exit(EXIT_SUCCESS);
+        }else if(argv[i][0] != '-'){
+            //Summary files to merge, which only make sense with --merge-summaries (checked below)
+            opts->merge_paths[opts->num_merge_paths] = argv[i];
+            opts->num_merge_paths++;
+        }else{
+            fprintf(stderr, "ERROR in parse_options() : Didn't understand %s\n", argv[i]);
+            print_usage(stderr, argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    //Fill in the defaults for anything that wasn't given (or was given as an empty list)
+    if(opts->num_policies == 0){
+        char default_policy[] = "sjf";
+        parse_policy_list(default_policy, opts, argv[0]);
+    }
+    if(opts->num_cpu_counts == 0){
+        char default_cpus[] = "1";
+        parse_size_list(default_cpus, &opts->cpu_counts, &opts->num_cpu_counts);
+    }
+    if(opts->num_quanta == 0){
+        char default_quantum[] = "0";
+        parse_size_list(default_quantum, &opts->quanta, &opts->num_quanta);
+    }
+
+    size_t k;
+    for(k = 0; k < opts->num_cpu_counts; k++){
+        if(opts->cpu_counts[k] == 0 || opts->cpu_counts[k] > MAX_CPUS){
+            fprintf(stderr, "ERROR in parse_options() : There has to be at least 1 CPU, and at most %zu\n", MAX_CPUS);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if(!opts->sweep && (opts->num_policies > 1 || opts->num_cpu_counts > 1 || opts->num_quanta > 1)){
+        fprintf(stderr, "ERROR in parse_options() : Lists of policies, CPU counts or quanta only make sense with --sweep\n");
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if(opts->sweep && opts->trace_path != NULL){
+        fprintf(stderr, "ERROR in parse_options() : --trace only works on a single schedule, not a --sweep\n");
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if(opts->sweep && opts->summary_path != NULL){
+        fprintf(stderr, "ERROR in parse_options() : --summary-out only works on a single schedule, not a --sweep\n");
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if(!opts->merge && opts->num_merge_paths > 0){
+        fprintf(stderr, "ERROR in parse_options() : Didn't understand %s\n", opts->merge_paths[0]);
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if(opts->merge && (opts->num_merge_paths == 0 || opts->sweep || opts->trace_path != NULL)){
+        fprintf(stderr, "ERROR in parse_options() : --merge-summaries needs at least one summary file, and nothing to schedule\n");
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    if((opts->serve_path != NULL || opts->client_path != NULL) && (opts->sweep || opts->merge || opts->trace_path != NULL
+        || opts->summary_path != NULL || opts->weights_path != NULL || (opts->serve_path != NULL && opts->client_path != NULL))){
+        fprintf(stderr, "ERROR in parse_options() : --serve and --client only go with --policy, --cpus and --quantum\n");
+        print_usage(stderr, argv[0]);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void destroy_options(options* opts){
+    free(opts->merge_paths);
+    free(opts->policies);
+    free(opts->cpu_counts);
+    free(opts->quanta);
+}
+
+size_t count_threads(options* opts, size_t num_tasks){
+    //No point having more threads than tasks, or more than the machine can run at once unless asked for
+    size_t num_threads = opts->num_threads;
+    if(num_threads == 0){
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = online > 0 ? (size_t)online : 1;
+    }
+    if(num_threads > num_tasks){
+        num_threads = num_tasks;
+    }
+    return num_threads;
+}
+
+void print_usage(FILE* stream, char* program_name){
+    fprintf(stream, "Usage: %s [--policy sjf|fair|edf|rr] [--cpus N] [--quantum N] [--weights FILE] [--trace FILE] [--summary-out FILE] < jobs.txt\n"
+                    "       %s --sweep [--policy LIST] [--cpus LIST] [--quantum LIST] [--threads N] [--weights FILE] < jobs.txt\n"
+                    "       %s --merge-summaries [--threads N] [--summary-out FILE] SUMMARY...\n"
+                    "       %s --serve SOCKET [--policy sjf|fair|edf|rr] [--cpus N] [--quantum N]\n"
+                    "       %s --client SOCKET < requests.txt\n"
+                    "  --policy sjf      shortest job first (default)\n"
+                    "  --policy fair     fair share between people, shortest job first within each person\n"
+                    "  --policy edf      earliest deadline first, rejecting jobs that can't make their deadline\n"
+                    "  --policy rr       round robin, first come first served until the quantum runs out\n"
+                    "  --cpus N          how many CPUs to schedule across (default 1)\n"
+                    "  --quantum N       most time slots a job runs before the scheduler takes another look (default 0, no limit).\n"
+                    "                    With --policy fair, the least a job runs before someone else can go (default the\n"
+                    "                    job's duration / %d)\n"
+                    "  --weights FILE    fair share weights, one \"person weight\" pair per line (default weight %d)\n"
+                    "  --trace FILE      also write the schedule to FILE as a Chrome/Perfetto trace (open it in ui.perfetto.dev)\n"
+                    "  --sweep           schedule every combination of the comma separated lists given to --policy, --cpus\n"
+                    "                    and --quantum (ex. --cpus 1,2,4) and print a table comparing them\n"
+                    "  --threads N       how many configs a sweep runs, or summary files are merged, at once (default one per core)\n"
+                    "  --summary-out FILE  also write each person's summary to FILE in a binary form that can be merged later\n"
+                    "  --merge-summaries   combine summary files written by --summary-out (ex. one per shard of a big input) and\n"
+                    "                      print the Summary they add up to\n"
+                    "  --serve SOCKET    run as a daemon on a Unix domain socket, taking jobs and answering when they complete\n"
+                    "  --client SOCKET   send the daemon one request per line: \"submit PERSON JOB ARRIVAL DURATION [DEADLINE]\",\n"
+                    "                    \"job JOB\" or \"person PERSON\", and print the answers\n",
+                    program_name, program_name, program_name, program_name, program_name, FAIR_SHARE_SLICES_PER_JOB, DEFAULT_WEIGHT
+            );
+}
+
+size_t* read_weights(char* path, job_table* table){
+    FILE* weights_file = fopen(path, "r");
+    if(weights_file == NULL){
+        fprintf(stderr, "ERROR in read_weights() : Could not open %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    size_t* weights = (size_t*)malloc((table->num_people + 1) * sizeof(size_t));
+    if(weights == NULL){
+        fprintf(stderr, "ERROR in read_weights() : Could not allocate space for weights\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t i;
+    for(i = 0; i < table->num_people; i++){
+        weights[i] = DEFAULT_WEIGHT;
+    }
+
+    size_t line_size = INITIAL_BUFFER_SIZE;
+    char* line = (char*)malloc(line_size * sizeof(char));
+    if(line == NULL){
+        fprintf(stderr, "ERROR in read_weights() : Could not allocate space for input line\n");
+        exit(EXIT_FAILURE);
+    }
+    while(getline(&line, &line_size, weights_file) != -1){
+        replace_whitespace(line, ',');
+        char* tokens[2];
+        size_t num_line_tokens = tokenize_line(line, tokens, 2);
+        if(num_line_tokens == 0){
+            continue;
+        }
+        if(num_line_tokens != 2){
+            fprintf(stderr, "ERROR in read_weights() : Expected a person and a weight, found %zu columns\n", num_line_tokens);
+            exit(EXIT_FAILURE);
+        }
+
+        size_t weight = strtosizet(tokens[1]);
+        if(weight == 0){
+            fprintf(stderr, "ERROR in read_weights() : %s has a weight of 0, weights have to be at least 1\n", tokens[0]);
+            exit(EXIT_FAILURE);
+        }
+        size_t person = name_map_get(table->people, tokens[0]);
+        if(person != NAME_NOT_FOUND){
+            weights[person] = weight;
+        }
+    }
+
+    free(line);
+    fclose(weights_file);
+    return weights;
+}
+
+//-----------------------SWEEP IMPLEMENTATIONS-----------------------//
+
+/**
+ * What each worker thread runs. Keeps taking configs until there are none left
+ */
+static void* sweep_worker(void* sw_v){
+    sweep* sw = (sweep*)sw_v;
+    while(1){
+        pthread_mutex_lock(&sw->lock);
+        size_t c = sw->next_config;
+        if(c < sw->num_configs){
+            sw->next_config++;
+        }
+        pthread_mutex_unlock(&sw->lock);
+        if(c >= sw->num_configs){
+            return NULL;
+        }
+
+        schedule* s = schedule_jobs(sw->table, sw->graph, &sw->configs[c]);
+        summarize_schedule(s, sw->table, &sw->results[c]);
+        destroy_schedule(s);
+    }
+}
+
+/**
+ * Starts num_threads threads running worker(arg) and waits for all of them to finish
+ */
+static void run_workers(void* (*worker)(void*), void* arg, size_t num_threads){
+    pthread_t* threads = (pthread_t*)malloc((num_threads + 1) * sizeof(pthread_t));
+    if(threads == NULL){
+        fprintf(stderr, "ERROR in run_workers() : Could not allocate space for threads\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t t;
+    for(t = 0; t < num_threads; t++){
+        if(pthread_create(&threads[t], NULL, worker, arg) != 0){
+            fprintf(stderr, "ERROR in run_workers() : Could not start thread %zu\n", t);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for(t = 0; t < num_threads; t++){
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+}
+
+void run_sweep(job_table* table, dependency_graph* graph, size_t* weights, options* opts){
+    sweep sw;
+    sw.table = table;
+    sw.graph = graph;
+    sw.num_configs = opts->num_policies * opts->num_cpu_counts * opts->num_quanta;
+    sw.next_config = 0;
+    sw.configs = (scheduler_config*)malloc(sw.num_configs * sizeof(scheduler_config));
+    sw.results = (sweep_result*)calloc(sw.num_configs, sizeof(sweep_result));
+    if(sw.configs == NULL || sw.results == NULL){
+        fprintf(stderr, "ERROR in run_sweep() : Could not allocate space for configs\n");
+        exit(EXIT_FAILURE);
+    }
+    if(pthread_mutex_init(&sw.lock, NULL) != 0){
+        fprintf(stderr, "ERROR in run_sweep() : Could not create lock\n");
+        exit(EXIT_FAILURE);
+    }
+
+    //Every combination, in the order they were given on the command line
+    size_t c = 0;
+    size_t p, n, q;
+    for(p = 0; p < opts->num_policies; p++){
+        for(n = 0; n < opts->num_cpu_counts; n++){
+            for(q = 0; q < opts->num_quanta; q++){
+                sw.configs[c].policy = opts->policies[p];
+                sw.configs[c].num_cpus = opts->cpu_counts[n];
+                sw.configs[c].quantum = opts->quanta[q];
+                sw.configs[c].weights = weights;
+                sw.configs[c].trace = NULL;
+                c++;
+            }
+        }
+    }
+
+    run_workers(sweep_worker, &sw, count_threads(opts, sw.num_configs));
+
+    print_sweep(&sw);
+
+    for(c = 0; c < sw.num_configs; c++){
+        free(sw.results[c].latest_completion);
+    }
+    pthread_mutex_destroy(&sw.lock);
+    free(sw.results);
+    free(sw.configs);
+}
+
+void summarize_schedule(schedule* s, job_table* table, sweep_result* result){
+    result->latest_completion = (size_t*)malloc((table->num_people + 1) * sizeof(size_t));
+    if(result->latest_completion == NULL){
+        fprintf(stderr, "ERROR in summarize_schedule() : Could not allocate space for completion times\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t i;
+    for(i = 0; i < table->num_people; i++){
+        result->latest_completion[i] = SIZE_MAX;
+    }
+
+    result->makespan = s->makespan;
+    result->num_late = 0;
+    result->num_rejected = s->num_rejected;
+
+    double total_turnaround = 0.0;
+    double total_wait = 0.0;
+    size_t num_completed = 0;
+    for(i = 0; i < table->length; i++){
+        if(s->rejected[i]){
+            continue;
+        }
+        size_t completion = s->completion_times[i];
+        if(table->deadlines[i] != NO_DEADLINE && completion > table->deadlines[i]){
+            result->num_late++;
+        }
+        size_t* latest = &result->latest_completion[table->person_ids[i]];
+        if(*latest == SIZE_MAX || completion > *latest){
+            *latest = completion;
+        }
+        total_turnaround += (double)(completion - table->arrival_times[i]);
+        total_wait += (double)(completion - table->arrival_times[i] - table->durations[i]);
+        num_completed++;
+    }
+
+    result->mean_turnaround = num_completed == 0 ? 0.0 : total_turnaround / (double)num_completed;
+    result->mean_wait = num_completed == 0 ? 0.0 : total_wait / (double)num_completed;
+}
+
+void print_sweep(sweep* sw){
+    fprintf(stdout, "Config\tPolicy\tCPUs\tQuantum\tMakespan\tMean Turnaround\tMean Wait\tLate\tRejected\n");
+    size_t c;
+    for(c = 0; c < sw->num_configs; c++){
+        scheduler_config* config = &sw->configs[c];
+        sweep_result* result = &sw->results[c];
+        fprintf(stdout, "%zu\t%s\t%zu\t%zu\t%zu\t%.2f\t%.2f\t%zu\t%zu\n",
+                c, policy_names[config->policy], config->num_cpus, config->quantum, result->makespan,
+                result->mean_turnaround, result->mean_wait, result->num_late, result->num_rejected
+        );
+    }
+
+    //One column per config, numbered the same as the table above
+    fprintf(stdout, "\nSummary");
+    for(c = 0; c < sw->num_configs; c++){
+        fprintf(stdout, "\t%zu", c);
+    }
+    fprintf(stdout, "\n");
+    size_t i;
+    for(i = 0; i < sw->table->num_people; i++){
+        fprintf(stdout, "%s ", get_person_name(sw->table, i));
+        for(c = 0; c < sw->num_configs; c++){
+            size_t latest = sw->results[c].latest_completion[i];
+            if(latest == SIZE_MAX){
+                fprintf(stdout, "\t-");
+            }else{
+                fprintf(stdout, "\t%zu", latest);
+            }
+        }
+        fprintf(stdout, "\n");
+    }
+}
+
+//-----------------------SUMMARY IMPLEMENTATIONS-----------------------//
+
+summary* create_summary(){
+    void* to_return_v = malloc(sizeof(summary));
+    if(to_return_v == NULL){
+        fprintf(stderr, "ERROR in create_summary() : Could not allocate space for summary struct\n");
+        exit(EXIT_FAILURE);
+    }
+    summary* to_return = (summary*)to_return_v;
+    to_return->people = NULL;
+    to_return->names = NULL;
+    to_return->num_people = 0;
+    to_return->capacity = 0;
+    to_return->partition_offsets = NULL;
+    to_return->partition_order = NULL;
+    to_return->strings = create_string_table();
+    to_return->ids = to_return->strings == NULL ? NULL : create_name_map(to_return->strings);
+    if(to_return->ids == NULL){
+        fprintf(stderr, "ERROR in create_summary() : Could not allocate space for name map\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return to_return;
+}
+
+/**
+ * Makes room for at least capacity people, so a summary whose size is known up front isn't copied as it grows
+ */
+static void reserve_summary(summary* sum, size_t capacity){
+    if(capacity <= sum->capacity){
+        return;
+    }
+    void* people_v = realloc(sum->people, capacity * sizeof(person_summary));
+    void* names_v = realloc(sum->names, capacity * sizeof(uint32_t));
+    if(people_v == NULL || names_v == NULL){
+        fprintf(stderr, "ERROR in reserve_summary() : Could not grow summary\n");
+        exit(EXIT_FAILURE);
+    }
+    sum->people = (person_summary*)people_v;
+    sum->names = (uint32_t*)names_v;
+    sum->capacity = capacity;
+}
+
+size_t summary_find_person(summary* sum, char* name){
+    size_t index = name_map_get(sum->ids, name);
+    if(index != NAME_NOT_FOUND){
+        return index;
+    }
+
+    if(sum->num_people == sum->capacity){
+        if(sum->num_people == NAME_MAP_EMPTY){
+            fprintf(stderr, "ERROR in summary_find_person() : More than %u people\n", NAME_MAP_EMPTY);
+            exit(EXIT_FAILURE);
+        }
+        reserve_summary(sum, sum->capacity == 0 ? 16 : sum->capacity * 2);
+    }
+
+    index = sum->num_people;
+    memset(&sum->people[index], 0, sizeof(person_summary));
+    sum->people[index].latest_completion = UINT64_MAX;
+    sum->people[index].first_seen = UINT64_MAX;
+    sum->names[index] = add_string(sum->strings, name);
+    name_map_put(sum->ids, sum->names[index], (uint32_t)index);
+    sum->num_people++;
+    return index;
+}
+
+summary* summarize_people(schedule* s, job_table* table){
+    summary* sum = create_summary();
+    reserve_summary(sum, table->num_people);
+
+    //Add everyone in person_id order first, so their index in the summary is their person_id
+    size_t i;
+    for(i = 0; i < table->num_people; i++){
+        summary_find_person(sum, get_person_name(table, i));
+        sum->people[i].first_seen = i;
+    }
+
+    for(i = 0; i < table->length; i++){
+        person_summary* person = &sum->people[table->person_ids[i]];
+        person->num_jobs++;
+        if(s->rejected[i]){
+            person->num_rejected++;
+            continue;
+        }
+
+        uint64_t completion = s->completion_times[i];
+        if(table->deadlines[i] != NO_DEADLINE && completion > table->deadlines[i]){
+            person->num_late++;
+        }
+        if(person->latest_completion == UINT64_MAX || completion > person->latest_completion){
+            person->latest_completion = completion;
+        }
+
+        uint64_t turnaround = completion - table->arrival_times[i];
+        size_t bucket = 0;
+        uint64_t bits = turnaround;
+        while(bits > 0){
+            bucket++;
+            bits >>= 1;
+        }
+        person->num_completed++;
+        person->turnaround_total += turnaround;
+        person->turnaround_buckets[bucket]++;
+        if(turnaround > person->turnaround_max){
+            person->turnaround_max = turnaround;
+        }
+    }
+
+    return sum;
+}
+
+void merge_person_summary(person_summary* into, person_summary* from){
+    if(from->latest_completion != UINT64_MAX && (into->latest_completion == UINT64_MAX || from->latest_completion > into->latest_completion)){
+        into->latest_completion = from->latest_completion;
+    }
+    into->num_jobs += from->num_jobs;
+    into->num_completed += from->num_completed;
+    into->num_late += from->num_late;
+    into->num_rejected += from->num_rejected;
+    into->turnaround_total += from->turnaround_total;
+    if(from->turnaround_max > into->turnaround_max){
+        into->turnaround_max = from->turnaround_max;
+    }
+    size_t b;
+    for(b = 0; b < SUMMARY_BUCKETS; b++){
+        into->turnaround_buckets[b] += from->turnaround_buckets[b];
+    }
+    if(from->first_seen < into->first_seen){
+        into->first_seen = from->first_seen;
+    }
+}
+
+/**
+ * Numbers are written little endian whatever machine this runs on, so summaries can be merged on a different one
+ */
+static void write_number(FILE* stream, char* path, uint64_t value, size_t num_bytes){
+    unsigned char bytes[8];
+    size_t i;
+    for(i = 0; i < num_bytes; i++){
+        bytes[i] = (unsigned char)(value >> (8 * i));
+    }
+    if(fwrite(bytes, 1, num_bytes, stream) != num_bytes){
+        fprintf(stderr, "ERROR in write_number() : Could not write to %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * A whole summary file read into memory, and how far into it read_summary() has got
+ */
+typedef struct summary_file{
+    unsigned char* data;
+    size_t length;
+    size_t position;
+    char* path;
+} summary_file;
+
+static uint64_t read_number(summary_file* file, size_t num_bytes){
+    if(file->length - file->position < num_bytes){
+        fprintf(stderr, "ERROR in read_number() : %s is cut short, or isn't a summary\n", file->path);
+        exit(EXIT_FAILURE);
+    }
+    uint64_t value = 0;
+    size_t i;
+    for(i = 0; i < num_bytes; i++){
+        value |= (uint64_t)file->data[file->position + i] << (8 * i);
+    }
+    file->position += num_bytes;
+    return value;
+}
+
+void write_summary(summary* sum, char* path){
+    FILE* stream = fopen(path, "wb");
+    if(stream == NULL){
+        fprintf(stderr, "ERROR in write_summary() : Could not open %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    //Header: magic, version, number of people
+    if(fwrite(SUMMARY_MAGIC, 1, strlen(SUMMARY_MAGIC), stream) != strlen(SUMMARY_MAGIC)){
+        fprintf(stderr, "ERROR in write_summary() : Could not write to %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    write_number(stream, path, SUMMARY_VERSION, 4);
+    write_number(stream, path, sum->num_people, 8);
+
+    //Then each person: their name, their numbers, and only the turnaround buckets that have something in them
+    size_t i, b;
+    for(i = 0; i < sum->num_people; i++){
+        person_summary* person = &sum->people[i];
+        char* name = get_string(sum->strings, sum->names[i]);
+        size_t name_length = strlen(name);
+        write_number(stream, path, name_length, 4);
+        if(fwrite(name, 1, name_length, stream) != name_length){
+            fprintf(stderr, "ERROR in write_summary() : Could not write to %s : %s\n", path, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+        write_number(stream, path, person->latest_completion, 8);
+        write_number(stream, path, person->num_jobs, 8);
+        write_number(stream, path, person->num_completed, 8);
+        write_number(stream, path, person->num_late, 8);
+        write_number(stream, path, person->num_rejected, 8);
+        write_number(stream, path, person->turnaround_total, 8);
+        write_number(stream, path, person->turnaround_max, 8);
+        size_t num_buckets = 0;
+        for(b = 0; b < SUMMARY_BUCKETS; b++){
+            num_buckets += person->turnaround_buckets[b] != 0;
+        }
+        write_number(stream, path, num_buckets, 1);
+        for(b = 0; b < SUMMARY_BUCKETS; b++){
+            if(person->turnaround_buckets[b] != 0){
+                write_number(stream, path, b, 1);
+                write_number(stream, path, person->turnaround_buckets[b], 8);
+            }
+        }
+    }
+
+    if(fclose(stream) != 0){
+        fprintf(stderr, "ERROR in write_summary() : Could not finish writing %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+}
+
+summary* read_summary(char* path){
+    FILE* stream = fopen(path, "rb");
+    if(stream == NULL){
+        fprintf(stderr, "ERROR in read_summary() : Could not open %s : %s\n", path, strerror(errno));
         exit(EXIT_FAILURE);
     }
 
-    char* line = (char*)line_v;
-    //read and disregard first line as header
-    fgets(line, INITIAL_BUFFER_SIZE, stdin);
-
-    while(fgets(line, INITIAL_BUFFER_SIZE, stdin) != NULL){
-        //If last character is a newline, a full line was read (GOOD!)
-        // otherwise the buffer wasn't big enough
-        if(line && line[strlen(line)-1] == '\n'){
-
-            //line was initially allocated a lot of memory which it probably doesn't need.
-            // So, we'll reallocate it to only use what it needs.
-            void* err = realloc(line, strlen(line) * sizeof(char));
-            if(err == NULL){
-                fprintf(stderr, "ERROR in main() : attempt to realloc() space for input line has failed\n");
+    //Read the whole file in one go, pulling it apart a field at a time through stdio is much slower
+    summary_file file;
+    file.path = path;
+    file.length = 0;
+    file.position = 0;
+    size_t capacity = INITIAL_BUFFER_SIZE;
+    file.data = (unsigned char*)malloc(capacity);
+    if(file.data == NULL){
+        fprintf(stderr, "ERROR in read_summary() : Could not allocate space for %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    size_t num_read;
+    while((num_read = fread(file.data + file.length, 1, capacity - file.length, stream)) > 0){
+        file.length += num_read;
+        if(file.length == capacity){
+            capacity *= 2;
+            void* data_v = realloc(file.data, capacity);
+            if(data_v == NULL){
+                fprintf(stderr, "ERROR in read_summary() : Could not allocate space for %s\n", path);
                 exit(EXIT_FAILURE);
             }
+            file.data = (unsigned char*)data_v;
+        }
+    }
+    if(ferror(stream)){
+        fprintf(stderr, "ERROR in read_summary() : Could not read %s : %s\n", path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    fclose(stream);
 
-            //Now we have a pointer to a line of input, we need to get rid of whitespace.
-            replace_whitespace(line, ',');
-
-            //Now that each line is in csv format, we can tokenize it
-            char* rest = NULL;
-            char* token;
-            char* tokens[NUM_TOKENS];
-            int i = 0;
-            token = strtok_r(line, ",", &rest);
-            while(token != NULL){
-                tokens[i] = token;
-                token = strtok_r(NULL, ",", &rest);
-                i++;
-            }
-
-            //Now we have an array with all the information we need to create a job
-            char* person_name = tokens[0];
-            char* job_name = tokens[1];
-            size_t arrival_time = strtosizet(tokens[2]);
-            size_t duration = strtosizet(tokens[3]);
+    size_t magic_length = strlen(SUMMARY_MAGIC);
+    if(file.length < magic_length || memcmp(file.data, SUMMARY_MAGIC, magic_length) != 0){
+        fprintf(stderr, "ERROR in read_summary() : %s isn't a summary\n", path);
+        exit(EXIT_FAILURE);
+    }
+    file.position = magic_length;
+    uint64_t version = read_number(&file, 4);
+    if(version != SUMMARY_VERSION){
+        fprintf(stderr, "ERROR in read_summary() : %s is a version %llu summary, only version %d can be read\n", path, (unsigned long long)version, SUMMARY_VERSION);
+        exit(EXIT_FAILURE);
+    }
+    uint64_t num_people = read_number(&file, 8);
 
-            job* j = create_job(person_name, job_name, arrival_time, duration);
-            if(j == NULL){
-                fprintf(stderr, "ERROR in main() : Could not allocate space for job\n");
+    //Each person takes at least 61 bytes of the file, so a corrupt count can't make this reserve too much
+    summary* sum = create_summary();
+    reserve_summary(sum, num_people < file.length / 61 ? num_people : file.length / 61);
+    size_t name_size = INITIAL_BUFFER_SIZE;
+    char* name = (char*)malloc(name_size * sizeof(char));
+    if(name == NULL){
+        fprintf(stderr, "ERROR in read_summary() : Could not allocate space for name\n");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t i;
+    for(i = 0; i < num_people; i++){
+        size_t name_length = read_number(&file, 4);
+        if(file.length - file.position < name_length){
+            fprintf(stderr, "ERROR in read_summary() : %s is cut short, or isn't a summary\n", path);
+            exit(EXIT_FAILURE);
+        }
+        if(name_length + 1 > name_size){
+            name_size = name_length + 1;
+            void* name_v = realloc(name, name_size * sizeof(char));
+            if(name_v == NULL){
+                fprintf(stderr, "ERROR in read_summary() : Could not allocate space for name\n");
                 exit(EXIT_FAILURE);
             }
+            name = (char*)name_v;
+        }
+        memcpy(name, file.data + file.position, name_length);
+        name[name_length] = '\0';
+        file.position += name_length;
 
-            node* n = create_node(j);
-            if(n == NULL){
-                fprintf(stderr, "ERROR in main() : Could not allocate space for node\n");
+        //Someone listed twice just gets merged with themselves
+        person_summary from;
+        memset(&from, 0, sizeof(person_summary));
+        from.first_seen = i;
+        from.latest_completion = read_number(&file, 8);
+        from.num_jobs = read_number(&file, 8);
+        from.num_completed = read_number(&file, 8);
+        from.num_late = read_number(&file, 8);
+        from.num_rejected = read_number(&file, 8);
+        from.turnaround_total = read_number(&file, 8);
+        from.turnaround_max = read_number(&file, 8);
+        size_t num_buckets = read_number(&file, 1);
+        size_t b;
+        for(b = 0; b < num_buckets; b++){
+            size_t bucket = read_number(&file, 1);
+            if(bucket >= SUMMARY_BUCKETS){
+                fprintf(stderr, "ERROR in read_summary() : %s has a turnaround bucket out of range\n", path);
                 exit(EXIT_FAILURE);
             }
+            from.turnaround_buckets[bucket] += read_number(&file, 8);
+        }
+        size_t index = summary_find_person(sum, name);
+        merge_person_summary(&sum->people[index], &from);
+    }
 
-            //this node will get added to the job_list so we can print it out later. The other node will be used for more important purposes
-            node* n_copy = create_node(j);
-            if(n_copy == NULL){
-                fprintf(stderr, "ERROR in main() : Could not allocate space for node copy\n");
-                exit(EXIT_FAILURE);
-            }
+    free(name);
+    free(file.data);
+    return sum;
+}
 
-            add_node_to_job_list(&job_list_head, n_copy);
+typedef struct merge_state{
+    options* opts;
+    summary** files; //indexed the same as opts->merge_paths
+    summary** partitions;
+    size_t num_partitions;
+    size_t next_task;
+    pthread_mutex_t lock;
+} merge_state;
 
-            add_node_to_list(&head, n);
+static size_t take_merge_task(merge_state* m){
+    pthread_mutex_lock(&m->lock);
+    size_t task = m->next_task;
+    m->next_task++;
+    pthread_mutex_unlock(&m->lock);
+    return task;
+}
 
-        }else{
-            //255 characters is more than enough for any feasible input
-            // So, if that's not enough, the input must be beyond recovery so we exit()
-            fprintf(stderr, "ERROR in main() : Input buffer was not big enough : Are you sure you are inputting the right data?\n");
+/**
+ * Reads files until there are none left
+ */
+static void* merge_read_worker(void* m_v){
+    merge_state* m = (merge_state*)m_v;
+    size_t f;
+    while((f = take_merge_task(m)) < m->opts->num_merge_paths){
+        m->files[f] = read_summary(m->opts->merge_paths[f]);
+    }
+    return NULL;
+}
+
+/**
+ * Splits each file's people into partitions until there are no files left
+ */
+static void* merge_partition_worker(void* m_v){
+    merge_state* m = (merge_state*)m_v;
+    size_t f;
+    while((f = take_merge_task(m)) < m->opts->num_merge_paths){
+        summary* sum = m->files[f];
+        sum->partition_offsets = (size_t*)calloc(m->num_partitions + 2, sizeof(size_t));
+        sum->partition_order = (uint32_t*)malloc((sum->num_people + 1) * sizeof(uint32_t));
+        uint32_t* partition = (uint32_t*)malloc((sum->num_people + 1) * sizeof(uint32_t));
+        if(sum->partition_offsets == NULL || sum->partition_order == NULL || partition == NULL){
+            fprintf(stderr, "ERROR in merge_partition_worker() : Could not allocate space for partitions\n");
             exit(EXIT_FAILURE);
         }
 
+        //Counting sort of the people by partition
+        size_t i;
+        for(i = 0; i < sum->num_people; i++){
+            sum->people[i].first_seen |= (uint64_t)f << 32;
+            partition[i] = (uint32_t)(hash_name(get_string(sum->strings, sum->names[i])) % m->num_partitions);
+            sum->partition_offsets[partition[i] + 2]++;
+        }
+        for(i = 0; i < m->num_partitions; i++){
+            sum->partition_offsets[i + 2] += sum->partition_offsets[i + 1];
+        }
+        for(i = 0; i < sum->num_people; i++){
+            sum->partition_order[sum->partition_offsets[partition[i] + 1]++] = (uint32_t)i;
+        }
+        free(partition);
     }
+    return NULL;
+}
 
-    //At this point we have a list of correctly scheduled jobs!
-    //Add one final IDLE job to the very end
-    add_node_to_list_end(&head, create_idle_node());
+/**
+ * Merges partitions until there are none left. A partition holds the same people in every file, so each one can be
+ *  merged without looking at any other
+ */
+static void* merge_reduce_worker(void* m_v){
+    merge_state* m = (merge_state*)m_v;
+    size_t p;
+    while((p = take_merge_task(m)) < m->num_partitions){
+        //Everyone in the biggest file's share of the partition will be in the merged one too
+        summary* merged = create_summary();
+        size_t f, k;
+        for(f = 0; f < m->opts->num_merge_paths; f++){
+            reserve_summary(merged, m->files[f]->partition_offsets[p + 1] - m->files[f]->partition_offsets[p]);
+        }
+        for(f = 0; f < m->opts->num_merge_paths; f++){
+            summary* file = m->files[f];
+            for(k = file->partition_offsets[p]; k < file->partition_offsets[p + 1]; k++){
+                size_t i = file->partition_order[k];
+                size_t index = summary_find_person(merged, get_string(file->strings, file->names[i]));
+                merge_person_summary(&merged->people[index], &file->people[i]);
+            }
+        }
+        m->partitions[p] = merged;
+    }
+    return NULL;
+}
 
-    //print_full_list(head);
-    print_output(head, job_list_head);
-    destroy_list(head);
+typedef struct merged_person{
+    uint64_t first_seen;
+    size_t partition;
+    size_t index;
+} merged_person;
 
+static int compare_merged_people(const void* a_v, const void* b_v){
+    const merged_person* a = (const merged_person*)a_v;
+    const merged_person* b = (const merged_person*)b_v;
+    if(a->first_seen != b->first_seen){
+        return a->first_seen < b->first_seen ? -1 : 1;
+    }
     return 0;
 }
 
-//-----------------------JOB IMPLEMENTATIONS-----------------------//
+summary* merge_summaries(options* opts){
+    merge_state m;
+    m.opts = opts;
+    m.files = (summary**)calloc(opts->num_merge_paths + 1, sizeof(summary*));
+    if(m.files == NULL){
+        fprintf(stderr, "ERROR in merge_summaries() : Could not allocate space for summaries\n");
+        exit(EXIT_FAILURE);
+    }
+    if(pthread_mutex_init(&m.lock, NULL) != 0){
+        fprintf(stderr, "ERROR in merge_summaries() : Could not create lock\n");
+        exit(EXIT_FAILURE);
+    }
 
-job* create_job(char* person_name, char* job_name, size_t arrival_time, size_t duration){
-    void* to_return_v = malloc(sizeof(job));
-    if(to_return_v == NULL){
-        fprintf(stderr, "ERROR in create_job() : Could not allocate space for job name\n");
-        return NULL;
+    //Map: read and partition every file. There's a partition per thread, but no more than there are people, or than
+    // there are cores to merge them on
+    m.next_task = 0;
+    run_workers(merge_read_worker, &m, count_threads(opts, opts->num_merge_paths));
+    size_t num_people = 0;
+    size_t p, i;
+    for(i = 0; i < opts->num_merge_paths; i++){
+        num_people += m.files[i]->num_people;
+    }
+    m.num_partitions = count_threads(opts, num_people > 0 ? num_people : 1);
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if(online > 0 && m.num_partitions > (size_t)online){
+        m.num_partitions = (size_t)online;
     }
-    job* to_return = (job*)to_return_v;
+    m.partitions = (summary**)calloc(m.num_partitions + 1, sizeof(summary*));
+    if(m.partitions == NULL){
+        fprintf(stderr, "ERROR in merge_summaries() : Could not allocate space for summaries\n");
+        exit(EXIT_FAILURE);
+    }
+    m.next_task = 0;
+    run_workers(merge_partition_worker, &m, count_threads(opts, opts->num_merge_paths));
 
-    void* p_name_v = malloc(strlen(person_name) * sizeof(char));
-    if(p_name_v == NULL){
-        fprintf(stderr, "ERROR in create_job() : Could not allocate space for person_name\n");
-        free(to_return);
-        return NULL;
+    //Reduce: merge each partition across all the files
+    m.next_task = 0;
+    run_workers(merge_reduce_worker, &m, m.num_partitions);
+    for(i = 0; i < opts->num_merge_paths; i++){
+        destroy_summary(m.files[i]);
     }
-    char* p_name = (char*)p_name_v;
-    strcpy(p_name, person_name);
 
-    void* j_name_v = malloc(strlen(job_name) * sizeof(char));
-    if(j_name_v == NULL){
-        fprintf(stderr, "ERROR in create_job() : Could not allocate space for job name\n");
-        free(p_name);
-        free(to_return);
-        return NULL;
+    //Put the partitions back together in the order people first showed up, earliest file first
+    size_t total = 0;
+    for(p = 0; p < m.num_partitions; p++){
+        total += m.partitions[p]->num_people;
+    }
+    merged_person* order = (merged_person*)malloc((total + 1) * sizeof(merged_person));
+    if(order == NULL){
+        fprintf(stderr, "ERROR in merge_summaries() : Could not allocate space for merged order\n");
+        exit(EXIT_FAILURE);
     }
-    char* j_name = (char*)j_name_v;
-    strcpy(j_name, job_name);
+    size_t k = 0;
+    for(p = 0; p < m.num_partitions; p++){
+        for(i = 0; i < m.partitions[p]->num_people; i++){
+            order[k].first_seen = m.partitions[p]->people[i].first_seen;
+            order[k].partition = p;
+            order[k].index = i;
+            k++;
+        }
+    }
+    qsort(order, total, sizeof(merged_person), compare_merged_people);
 
-    to_return->person_name = p_name;
-    to_return->job_name = j_name;
-    to_return->arrival_time = arrival_time;
-    to_return->duration = duration;
+    summary* merged = create_summary();
+    reserve_summary(merged, total);
+    for(k = 0; k < total; k++){
+        summary* part = m.partitions[order[k].partition];
+        size_t index = summary_find_person(merged, get_string(part->strings, part->names[order[k].index]));
+        merged->people[index] = part->people[order[k].index];
+    }
 
-    return to_return;
+    free(order);
+    for(p = 0; p < m.num_partitions; p++){
+        destroy_summary(m.partitions[p]);
+    }
+    pthread_mutex_destroy(&m.lock);
+    free(m.partitions);
+    free(m.files);
+    return merged;
 }
 
-int is_job_idle(job* j){
-    if(strncmp(j->job_name, IDLE_JOB_NAME, strlen(IDLE_JOB_NAME)) == 0){
-        return 1;
+/**
+ * Returns a turnaround that at least fraction of the person's finished jobs beat or matched. Only the buckets are
+ *  known, so it's the top of the bucket the answer falls in (or their longest turnaround if that's lower)
+ */
+static uint64_t turnaround_percentile(person_summary* person, double fraction){
+    uint64_t target = (uint64_t)(fraction * (double)person->num_completed);
+    if((double)target < fraction * (double)person->num_completed){
+        target++;
     }
-
-    return 0;
+    uint64_t seen = 0;
+    size_t b;
+    for(b = 0; b < SUMMARY_BUCKETS; b++){
+        seen += person->turnaround_buckets[b];
+        if(seen >= target && seen > 0){
+            break;
+        }
+    }
+    uint64_t top = b == 0 ? 0 : (b >= 64 ? UINT64_MAX : ((uint64_t)1 << b) - 1);
+    return top < person->turnaround_max ? top : person->turnaround_max;
 }
 
-int add_node_to_job_list(node** head_ref, node* to_insert){
-    //for now just add one node to end
-
-    if(*head_ref == NULL){
-        //list is empty
-        *head_ref = to_insert;
-    }else{
-        //go to end
-        node* curr_node = *head_ref;
-        while(curr_node->next != NULL){
-            curr_node = curr_node->next;
+void print_summary(summary* sum){
+    fprintf(stdout, "Summary\tCompletion\tJobs\tLate\tRejected\tMean Turnaround\tp50 Turnaround\tp95 Turnaround\tMax Turnaround\n");
+    size_t i;
+    for(i = 0; i < sum->num_people; i++){
+        person_summary* person = &sum->people[i];
+        fprintf(stdout, "%s ", get_string(sum->strings, sum->names[i]));
+        if(person->latest_completion == UINT64_MAX){
+            fprintf(stdout, "\t-");
+        }else{
+            fprintf(stdout, "\t%llu", (unsigned long long)person->latest_completion);
         }
-        curr_node->next = to_insert;
+        fprintf(stdout, "\t%llu\t%llu\t%llu", (unsigned long long)person->num_jobs, (unsigned long long)person->num_late, (unsigned long long)person->num_rejected);
+        if(person->num_completed == 0){
+            fprintf(stdout, "\t-\t-\t-\t-\n");
+            continue;
+        }
+        fprintf(stdout, "\t%.2f\t%llu\t%llu\t%llu\n",
+                (double)person->turnaround_total / (double)person->num_completed,
+                (unsigned long long)turnaround_percentile(person, 0.5),
+                (unsigned long long)turnaround_percentile(person, 0.95),
+                (unsigned long long)person->turnaround_max
+        );
     }
-
-    return 0;
 }
 
-void print_job(job* j){
-    char* person_name = j->person_name;
-    char* job_name = j->job_name;
-    size_t arrival_time = j->arrival_time;
-    size_t duration = j->duration;
-
-    fprintf(stdout, "\n"
-                    "//-------JOB-------//\n"
-                    "Name:\t%s\n"
-                    "Job:\t%s\n"
-                    "Arrived:\t%zu\n"
-                    "Duration:\t%zu\n"
-                    "\n",
-                    person_name, job_name, arrival_time, duration
-            );
+void destroy_summary(summary* sum){
+    destroy_name_map(sum->ids);
+    destroy_string_table(sum->strings);
+    free(sum->partition_offsets);
+    free(sum->partition_order);
+    free(sum->names);
+    free(sum->people);
+    free(sum);
 }
 
-void destroy_job(job* j){
-    //free(j->person_name);
-    //free(j->job_name);
-    free(j);
+//-----------------------DAEMON IMPLEMENTATIONS-----------------------//
+
+/**
+ * Set by SIGINT or SIGTERM to stop the daemon's event loop
+ */
+static volatile sig_atomic_t daemon_stopping = 0;
+
+static void stop_daemon(int signal_number){
+    (void)signal_number;
+    daemon_stopping = 1;
 }
 
-//-----------------------LINKED LIST IMPLEMENTATIONS-----------------------//
+static char* status_descriptions[] = {"ok", "not found", "rejected", "duplicate job name", "bad request", "full"};
 
-node* create_node(job* j){
-    void* to_return_v = malloc(sizeof(node));
-    if(to_return_v == NULL){
-        fprintf(stderr, "ERROR in create_node() : Could not allocate space for node struct\n");
-        return NULL;
+static void encode_number(unsigned char* bytes, uint64_t value, size_t num_bytes){
+    size_t i;
+    for(i = 0; i < num_bytes; i++){
+        bytes[i] = (unsigned char)(value >> (8 * i));
     }
-    node* to_return = (node*)to_return_v;
-    to_return->job = j;
-    to_return->next = NULL;
-
-    return to_return;
 }
 
-node* create_idle_node(){
-    void* to_return_v = malloc(sizeof(node));
-    if(to_return_v == NULL){
-        fprintf(stderr, "ERROR in create_idle_node() : Could not allocate space for node struct\n");
-        return NULL;
+static uint64_t decode_number(unsigned char* bytes, size_t num_bytes){
+    uint64_t value = 0;
+    size_t i;
+    for(i = 0; i < num_bytes; i++){
+        value |= (uint64_t)bytes[i] << (8 * i);
     }
-    node* to_return = (node*)to_return_v;
+    return value;
+}
 
-    void* idle_job_v = malloc(sizeof(job));
-    if(idle_job_v == NULL){
-        fprintf(stderr, "ERROR in create_idle_node() : Could not allocate space for idle job struct\n");
-        return NULL;
+/**
+ * Makes sure *bytes has room for at least needed bytes, doubling it if it doesn't
+ */
+static void reserve_bytes(unsigned char** bytes, size_t* capacity, size_t needed){
+    if(needed <= *capacity){
+        return;
     }
-    job* idle_job = (job*)idle_job_v;
-
-    idle_job->arrival_time = 0; //Arrival time and duration's values don't matter, they will never be read.
-    idle_job->duration = 0;
-    idle_job->job_name = IDLE_JOB_NAME;
-    idle_job->person_name = IDLE_JOB_NAME;
+    size_t new_capacity = *capacity == 0 ? 4096 : *capacity * 2;
+    while(new_capacity < needed){
+        new_capacity *= 2;
+    }
+    void* bytes_v = realloc(*bytes, new_capacity);
+    if(bytes_v == NULL){
+        fprintf(stderr, "ERROR in reserve_bytes() : Could not grow buffer to %zu bytes\n", new_capacity);
+        exit(EXIT_FAILURE);
+    }
+    *bytes = (unsigned char*)bytes_v;
+    *capacity = new_capacity;
+}
 
-    to_return->job = idle_job;
-    to_return->next = NULL;
-    return to_return;
+static int set_nonblocking(int fd){
+    int flags = fcntl(fd, F_GETFL, 0);
+    if(flags < 0){
+        return -1;
+    }
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
 }
 
-size_t get_length_list(node* head){
-    node* curr_node = head;
-    size_t index = 0;
-    while(curr_node != NULL){
-        index++;
-        curr_node = curr_node->next;
+static void close_connection(scheduler_daemon* d, daemon_connection* c){
+    if(c->waiting_for != 0){
+        d->num_waiting--;
     }
-    return index;
+    epoll_ctl(d->epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    d->num_connections--;
+    d->connections[c->index] = d->connections[d->num_connections];
+    d->connections[c->index]->index = c->index;
+    free(c->in);
+    free(c->out);
+    free(c);
 }
 
-void reverse_list(node** head){
-    node* prev = NULL;
-    node* next = NULL;
-    node* curr_node = *head;
+static void accept_connections(scheduler_daemon* d){
+    while(1){
+        int fd = accept(d->listen_fd, NULL, NULL);
+        if(fd < 0){
+            if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED){
+                fprintf(stderr, "ERROR in accept_connections() : Could not accept a connection : %s\n", strerror(errno));
+            }
+            return;
+        }
+
+        daemon_connection* c = (daemon_connection*)calloc(1, sizeof(daemon_connection));
+        if(c == NULL || set_nonblocking(fd) != 0){
+            fprintf(stderr, "ERROR in accept_connections() : Could not set up a connection\n");
+            free(c);
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+        struct epoll_event event;
+        event.events = c->events;
+        event.data.ptr = c;
+        if(epoll_ctl(d->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0){
+            fprintf(stderr, "ERROR in accept_connections() : Could not watch a connection : %s\n", strerror(errno));
+            free(c);
+            close(fd);
+            continue;
+        }
 
-    while(curr_node != NULL){
-        next = curr_node->next;
-        curr_node->next = prev;
-        prev = curr_node;
-        curr_node = next;
+        if(d->num_connections == d->connections_capacity){
+            size_t new_capacity = d->connections_capacity == 0 ? 16 : d->connections_capacity * 2;
+            void* connections_v = realloc(d->connections, new_capacity * sizeof(daemon_connection*));
+            void* batch_v = realloc(d->batch, new_capacity * sizeof(daemon_connection*));
+            if(connections_v == NULL || batch_v == NULL){
+                fprintf(stderr, "ERROR in accept_connections() : Could not grow connection list\n");
+                exit(EXIT_FAILURE);
+            }
+            d->connections = (daemon_connection**)connections_v;
+            d->batch = (daemon_connection**)batch_v;
+            d->connections_capacity = new_capacity;
+        }
+        c->index = d->num_connections;
+        d->connections[d->num_connections] = c;
+        d->num_connections++;
     }
-    *head = prev;
 }
 
-size_t get_last_index_of_job_2(node** head_ref, job* j){
-    //First, reverse list
-    reverse_list(head_ref);
-    node* curr_node = *head_ref;
-    size_t index = get_length_list(*head_ref);
-    while(curr_node != NULL){
-        if(strncmp(curr_node->job->job_name, j->job_name, strlen(j->job_name)) == 0){
-            //We found a match!
-            reverse_list(head_ref);
-            return index;
+/**
+ * Reads whatever the client has sent, up to DAEMON_MAX_READ at a time so one busy client can't hold everyone else up
+ * Returns 0 if the connection is still good, -1 if it broke
+ */
+static int read_connection(daemon_connection* c){
+    size_t num_read = 0;
+    while(num_read < DAEMON_MAX_READ && !c->closing){
+        reserve_bytes(&c->in, &c->in_capacity, c->in_length + 4096);
+        ssize_t n = read(c->fd, c->in + c->in_length, c->in_capacity - c->in_length);
+        if(n > 0){
+            c->in_length += (size_t)n;
+            num_read += (size_t)n;
+        }else if(n == 0){
+            c->closing = 1;
+        }else if(errno == EAGAIN || errno == EWOULDBLOCK){
+            break;
+        }else if(errno != EINTR){
+            return -1;
         }
-        index--;
-        curr_node = curr_node->next;
     }
-    reverse_list(head_ref);
     return 0;
 }
 
-size_t get_last_index_of_job(node* head, job* j){
-    //We need to find the last node with a given job in it.
-    node* curr_node = head;
-    size_t index = get_length_list(head);
-    while(curr_node != NULL){
-        if(strncmp(curr_node->job->job_name, j->job_name, strlen(j->job_name)) == 0){
-            //We found a match!
-            return index;
+/**
+ * Sends as much of the connection's waiting responses as the socket will take, then sets what epoll watches it for.
+ *  A client with lots of responses it hasn't read yet isn't read from until it catches up, and neither is one whose
+ *  requests are waiting on the scheduler.
+ * Returns 0 if the connection is still good, -1 if it broke
+ */
+static int flush_connection(scheduler_daemon* d, daemon_connection* c){
+    while(c->out_sent < c->out_length){
+        ssize_t n = send(c->fd, c->out + c->out_sent, c->out_length - c->out_sent, MSG_NOSIGNAL);
+        if(n > 0){
+            c->out_sent += (size_t)n;
+        }else if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            break;
+        }else if(n == 0 || errno != EINTR){
+            return -1;
+        }
+    }
+    if(c->out_sent == c->out_length){
+        c->out_sent = 0;
+        c->out_length = 0;
+    }
+
+    uint32_t events = 0;
+    if(!c->closing && c->waiting_for == 0 && c->out_length - c->out_sent < DAEMON_MAX_READ){
+        events |= EPOLLIN;
+    }
+    if(c->out_length > 0){
+        events |= EPOLLOUT;
+    }
+    if(events != c->events){
+        struct epoll_event event;
+        event.events = events;
+        event.data.ptr = c;
+        if(epoll_ctl(d->epoll_fd, EPOLL_CTL_MOD, c->fd, &event) != 0){
+            return -1;
         }
-        index--;
-        curr_node = curr_node->next;
+        c->events = events;
     }
     return 0;
 }
 
-void print_full_list(node* head){
-    node* curr_node = head;
-    size_t index = 0;
-    fprintf(stdout, "TIME\tJOB\n");
-    while(curr_node != NULL){
-        char* job_name = curr_node->job->job_name;
-        fprintf(stdout, "%zu\t%s\n", index, job_name);
-        index++;
-        curr_node = curr_node->next;
+static void append_response(daemon_connection* c, daemon_status status, uint32_t tag, uint64_t value){
+    if(c->out_length + DAEMON_RESPONSE_SIZE > c->out_capacity && c->out_sent > 0){
+        //Move what's still to send to the front rather than growing
+        memmove(c->out, c->out + c->out_sent, c->out_length - c->out_sent);
+        c->out_length -= c->out_sent;
+        c->out_sent = 0;
     }
+    reserve_bytes(&c->out, &c->out_capacity, c->out_length + DAEMON_RESPONSE_SIZE);
+    unsigned char* response = c->out + c->out_length;
+    response[0] = (unsigned char)status;
+    encode_number(response + 1, tag, 4);
+    encode_number(response + 5, value, 8);
+    c->out_length += DAEMON_RESPONSE_SIZE;
 }
 
-void print_output(node* head, node* job_list_head){
-    //Print header
-    fprintf(stdout, "Time\tJob\n");
+/**
+ * Copies a name out of a request into the given space, ending it with a '\0'.
+ * Returns the copy, or NULL if the name is empty or has something in it a jobs file couldn't (whitespace, commas, '\0')
+ */
+static char* copy_request_name(char* into, unsigned char* bytes, size_t length){
+    if(length == 0){
+        return NULL;
+    }
+    size_t i;
+    for(i = 0; i < length; i++){
+        if(bytes[i] == '\0' || bytes[i] == ',' || isspace(bytes[i])){
+            return NULL;
+        }
+    }
+    memcpy(into, bytes, length);
+    into[length] = '\0';
+    return into;
+}
 
-    //Print out the list from the first non-idle node to the end
-    // so first, find the first non-idle node
-    node* curr_node = head;
-    size_t index = 0;
-    while(is_job_idle(curr_node->job)){
-        index++;
-        curr_node = curr_node->next;
+static daemon_status submit_job(scheduler_daemon* d, unsigned char* body, size_t length){
+    if(length < DAEMON_SUBMIT_SIZE){
+        return STATUS_BAD_REQUEST;
+    }
+    uint64_t arrival_time = decode_number(body, 8);
+    uint64_t duration = decode_number(body + 8, 8);
+    uint64_t deadline = decode_number(body + 16, 8);
+    size_t person_length = decode_number(body + 24, 2);
+    if(person_length > length - DAEMON_SUBMIT_SIZE){
+        return STATUS_BAD_REQUEST;
     }
-    //Now curr_node is pointing to the first non-idle node so print out list
-    while(curr_node != NULL){
-        char* job_name = curr_node->job->job_name;
-        fprintf(stdout, "%zu\t\t%s\n", index, job_name);
-        index++;
-        curr_node = curr_node->next;
+    size_t job_length = length - DAEMON_SUBMIT_SIZE - person_length;
+    char* person_name = copy_request_name(d->names, body + DAEMON_SUBMIT_SIZE, person_length);
+    char* job_name = copy_request_name(d->names + UINT16_MAX + 1, body + DAEMON_SUBMIT_SIZE + person_length, job_length);
+    if(person_name == NULL || job_name == NULL || arrival_time > MAX_TIME_SLOT || duration > MAX_TIME_SLOT
+        || (deadline != DAEMON_NO_DEADLINE && deadline > MAX_TIME_SLOT)){
+        return STATUS_BAD_REQUEST;
     }
 
-    //Now print out summary header
-    fprintf(stdout, "\nSummary\n");
+    //Job names are how jobs get looked up, so they have to be unique
+    if(name_map_get(d->jobs, job_name) != NAME_NOT_FOUND){
+        return STATUS_DUPLICATE;
+    }
+    //add_job_to_table() gives up on the whole program when the table is full, which a daemon shouldn't
+    if(d->table->length + 1 >= NAME_MAP_EMPTY || d->table->strings->length + person_length + job_length + 2 > NAME_MAP_EMPTY){
+        return STATUS_FULL;
+    }
 
-    //Cultivate a list of unique jobs, where only the latest job from a person is included
-    node* cultivated_list_head = NULL;
-    curr_node = job_list_head;
-    while(curr_node != NULL){
-        node* copy = create_node(curr_node->job);
-        if(copy == NULL){
-            fprintf(stderr, "ERROR in print_output : Could not allocate space for copy node\n");
+    size_t num_people = d->table->num_people;
+    size_t job_index = add_job_to_table(d->table, person_name, job_name, arrival_time, duration,
+                                        deadline == DAEMON_NO_DEADLINE ? NO_DEADLINE : deadline, NULL);
+    name_map_put(d->jobs, d->table->job_names[job_index], (uint32_t)job_index);
+    if(d->table->length > d->jobs_capacity){
+        size_t new_capacity = d->jobs_capacity == 0 ? 1024 : d->jobs_capacity * 2;
+        void* previous_job_v = realloc(d->previous_job, new_capacity * sizeof(size_t));
+        if(previous_job_v == NULL){
+            fprintf(stderr, "ERROR in submit_job() : Could not grow list of jobs\n");
             exit(EXIT_FAILURE);
         }
-        add_node_to_cultivated_list(&cultivated_list_head, &head, copy);
-        curr_node = curr_node->next;
+        d->previous_job = (size_t*)previous_job_v;
+        d->jobs_capacity = new_capacity;
     }
-
-    //Now print out some stuff
-    curr_node = cultivated_list_head;
-    while(curr_node != NULL){
-        size_t final_index = get_last_index_of_job_2(&head, curr_node->job);
-        fprintf(stdout, "%s \t%zu\n", curr_node->job->person_name, final_index);
-        curr_node = curr_node->next;
+    size_t person_id = d->table->person_ids[job_index];
+    if(d->table->num_people > d->people_capacity){
+        size_t new_capacity = d->people_capacity == 0 ? 64 : d->people_capacity * 2;
+        void* last_job_v = realloc(d->last_job, new_capacity * sizeof(size_t));
+        if(last_job_v == NULL){
+            fprintf(stderr, "ERROR in submit_job() : Could not grow list of people\n");
+            exit(EXIT_FAILURE);
+        }
+        d->last_job = (size_t*)last_job_v;
+        d->people_capacity = new_capacity;
     }
+    d->previous_job[job_index] = person_id >= num_people ? SIZE_MAX : d->last_job[person_id];
+    d->last_job[person_id] = job_index;
+    if(arrival_time < d->stale_from){
+        d->stale_from = arrival_time;
+    }
+    return STATUS_OK;
 }
 
-void print_node(node* n){
-    job* j = n->job;
-    print_job(j);
-    if(n->next == NULL){
-        fprintf(stdout, "next is NULL\n");
-    }
+/**
+ * When a job stopped mattering to the rest of the schedule: when it finished, or one past when it was rejected.
+ *  SIZE_MAX if the scheduler hasn't worked it out yet
+ */
+static size_t job_settled_by(schedule* s, size_t job_index){
+    return s->rejected[job_index] ? s->ready_times[job_index] + 1 : s->completion_times[job_index];
 }
 
-void destroy_list(node* head){
-    while(head != NULL){
-        node* to_free = head;
-        head = head->next;
-        destroy_node(to_free);
+/**
+ * Returns 1 if the scheduler has worked a job out and the jobs it hasn't been given can't change that, 0 otherwise.
+ *  They can't if it has every job the query needs, or if the job was done with before the earliest of them arrives,
+ *  since the scheduler never looks ahead.
+ */
+static int job_answerable(scheduler_daemon* d, size_t job_index, int up_to_date){
+    if(job_index >= d->sch->num_jobs){
+        return 0;
     }
+    size_t settled_by = job_settled_by(d->sch->s, job_index);
+    return settled_by != SIZE_MAX && (up_to_date || settled_by <= d->stale_from);
 }
 
-void destroy_node(node* n){
-    destroy_job(n->job);
-    free(n);
+/**
+ * Answers a query from what the scheduler has worked out so far, if it can. needed is how many jobs had been
+ *  submitted when the query was, and only those count towards a person's answer.
+ * Returns 0 if it was answered, -1 if it has to wait for the scheduler
+ */
+static int answer_query(scheduler_daemon* d, daemon_request_type type, unsigned char* body, size_t length, size_t needed,
+                        daemon_status* status, uint64_t* value){
+    char* name = copy_request_name(d->names, body, length);
+    if(name == NULL){
+        *status = STATUS_BAD_REQUEST;
+        return 0;
+    }
+    int up_to_date = d->sch->num_jobs >= needed;
+    schedule* s = d->sch->s;
+
+    if(type == REQUEST_JOB){
+        size_t job_index = name_map_get(d->jobs, name);
+        if(job_index == NAME_NOT_FOUND){
+            *status = STATUS_NOT_FOUND;
+            return 0;
+        }
+        if(!job_answerable(d, job_index, up_to_date)){
+            return -1;
+        }
+        if(s->rejected[job_index]){
+            *status = STATUS_REJECTED;
+            return 0;
+        }
+        *status = STATUS_OK;
+        *value = s->completion_times[job_index];
+        return 0;
+    }
+
+    size_t person_id = name_map_get(d->table->people, name);
+    if(person_id == NAME_NOT_FOUND){
+        *status = STATUS_NOT_FOUND;
+        return 0;
+    }
+    size_t latest_completion = SIZE_MAX;
+    size_t job_index;
+    for(job_index = d->last_job[person_id]; job_index != SIZE_MAX; job_index = d->previous_job[job_index]){
+        if(job_index >= needed){
+            continue;
+        }
+        if(!job_answerable(d, job_index, up_to_date)){
+            return -1;
+        }
+        if(!s->rejected[job_index] && (latest_completion == SIZE_MAX || s->completion_times[job_index] > latest_completion)){
+            latest_completion = s->completion_times[job_index];
+        }
+    }
+    if(latest_completion == SIZE_MAX){
+        *status = STATUS_REJECTED;
+        return 0;
+    }
+    *status = STATUS_OK;
+    *value = latest_completion;
+    return 0;
 }
 
-size_t get_index_of_node(node* head, node* n){
-    node* curr_node = head;
-    size_t curr_index = 0;
-    int found = 0;
-    while(curr_node != NULL && (found == 0)){
-        if(curr_node == n){
-            found = 1;
-            return curr_index;
+/**
+ * Works on the schedule for a while for the connections waiting on it, then puts them in the batch to try again.
+ *  The jobs submitted since the scheduler was last given any are only handed over once it has worked out the ones it
+ *  has, so a steady stream of submissions can't keep it from ever finishing.
+ */
+static void advance_schedule(scheduler_daemon* d){
+    if(d->scheduled && d->sch->num_jobs < d->table->length){
+        scheduler_add_jobs(d->sch);
+        d->scheduled = 0;
+        d->stale_from = SIZE_MAX;
+    }
+    if(!d->scheduled){
+        d->scheduled = run_scheduler(d->sch, DAEMON_SCHEDULE_EVENTS);
+    }
+
+    size_t i;
+    for(i = 0; i < d->num_connections; i++){
+        daemon_connection* c = d->connections[i];
+        if(c->waiting_for != 0 && !c->batched){
+            c->batched = 1;
+            d->batch[d->num_batched] = c;
+            d->num_batched++;
         }
-        curr_index++;
-        curr_node = curr_node->next;
     }
-    return -1;
 }
 
-void add_node_to_cultivated_list(node** cultivated_list_head, node** head_ref, node* to_insert){
-    if(*cultivated_list_head == NULL){
-        (*cultivated_list_head) = to_insert;
-    }else{
-        node* curr_node = *cultivated_list_head;
-        while(curr_node->next != NULL){
-            if(strncmp(curr_node->job->person_name, to_insert->job->person_name, strlen(to_insert->job->person_name)) == 0){
-                //If the current job has the same person_name, compare their final indices
-                size_t presiding_final_index = get_last_index_of_job_2(head_ref, curr_node->job);
-                size_t incumbent_final_index = get_last_index_of_job_2(head_ref, to_insert->job);
-                if(presiding_final_index < incumbent_final_index){
-                    //New node ends later than curr_node, so replace jobs.
-                    curr_node->job = to_insert->job;
-                    return;
-                }else{
-                    return;
+/**
+ * Answers every whole request a connection has sent, in the order they were sent. A query the scheduler can't answer
+ *  yet holds up the connection's requests from there until it can. Everything submitted by then is given to the
+ *  scheduler at once, so a run of submissions costs one reschedule however long it is.
+ */
+static void handle_requests(scheduler_daemon* d, daemon_connection* c){
+    size_t position = 0;
+    while(c->in_length - position >= 2){
+        size_t length = decode_number(c->in + position, 2);
+        if(c->in_length - position - 2 < length){
+            break;
+        }
+        unsigned char* request = c->in + position + 2;
+        size_t start = position;
+        position += 2 + length;
+
+        if(length < DAEMON_HEADER_SIZE - 2){
+            append_response(c, STATUS_BAD_REQUEST, 0, 0);
+            continue;
+        }
+        daemon_request_type type = (daemon_request_type)request[0];
+        uint32_t tag = (uint32_t)decode_number(request + 1, 4);
+        unsigned char* body = request + DAEMON_HEADER_SIZE - 2;
+        size_t body_length = length - (DAEMON_HEADER_SIZE - 2);
+
+        if(type == REQUEST_SUBMIT){
+            append_response(c, submit_job(d, body, body_length), tag, 0);
+        }else if(type == REQUEST_JOB || type == REQUEST_PERSON){
+            //A query waits for the jobs submitted before it, not ones that came in while it was waiting
+            size_t needed = c->waiting_for != 0 ? c->waiting_for : d->table->length;
+            daemon_status status = STATUS_OK;
+            uint64_t value = 0;
+            if(answer_query(d, type, body, body_length, needed, &status, &value) != 0){
+                if(c->waiting_for == 0){
+                    d->num_waiting++;
                 }
+                c->waiting_for = needed;
+                position = start;
+                break;
             }
-            curr_node = curr_node->next;
+            if(c->waiting_for != 0){
+                d->num_waiting--;
+            }
+            c->waiting_for = 0;
+            append_response(c, status, tag, value);
+        }else{
+            append_response(c, STATUS_BAD_REQUEST, tag, 0);
         }
-        //If we're here, we didn't find a job with the same person_name, so add this job to the end of the list
-        curr_node->next = to_insert;
+    }
+
+    if(position > 0){
+        memmove(c->in, c->in + position, c->in_length - position);
+        c->in_length -= position;
     }
 }
 
-int add_node_to_list_end(node** head_ref, node* to_insert){
-    //for now just add one node to end
+/**
+ * Answers everything read this time round, then sends what it can back
+ */
+static void handle_batch(scheduler_daemon* d){
+    size_t i;
+    for(i = 0; i < d->num_batched; i++){
+        handle_requests(d, d->batch[i]);
+    }
 
-    if(*head_ref == NULL){
-        //list is empty
-        *head_ref = to_insert;
-    }else{
-        //go to end
-        node* curr_node = *head_ref;
-        while(curr_node->next != NULL){
-            curr_node = curr_node->next;
+    for(i = 0; i < d->num_batched; i++){
+        daemon_connection* c = d->batch[i];
+        c->batched = 0;
+        if(flush_connection(d, c) != 0 || (c->closing && c->out_length == 0 && c->waiting_for == 0)){
+            close_connection(d, c);
         }
-        curr_node->next = to_insert;
     }
+    d->num_batched = 0;
+}
 
-    return 0;
+/**
+ * Binds the daemon's socket. A socket file left behind by a daemon that's gone is replaced, but not one that a daemon
+ *  is still answering on.
+ */
+static void bind_daemon_socket(scheduler_daemon* d, struct sockaddr_un* address){
+    if(bind(d->listen_fd, (struct sockaddr*)address, sizeof(struct sockaddr_un)) == 0){
+        return;
+    }
+    if(errno == EADDRINUSE){
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int answered = probe >= 0 && connect(probe, (struct sockaddr*)address, sizeof(struct sockaddr_un)) == 0;
+        if(probe >= 0){
+            close(probe);
+        }
+        if(!answered && unlink(d->socket_path) == 0 && bind(d->listen_fd, (struct sockaddr*)address, sizeof(struct sockaddr_un)) == 0){
+            return;
+        }
+        errno = EADDRINUSE;
+    }
+    fprintf(stderr, "ERROR in bind_daemon_socket() : Could not listen on %s : %s\n", d->socket_path, strerror(errno));
+    exit(EXIT_FAILURE);
 }
 
-int add_node_to_list(node** head_ref, node* to_insert){
-    /* We need to create one job per time slice
-        if the job has duration 5, we need 5 jobs of durations 5, 4, 3, 2, 1
-        We then insert each job individually into the list, that way this scenario is handled
-            name    arrival duration
-            B       6       1
-            A       5       6
-        We get
-            time job duration
-            ...
-            5    A   6
-            6    B   1
-            7    A   5
-            ...
-        Which means each job will have an updated arrival time based on where the previous job was inserted
-
-        There are a few scenarios for inserting
-        1. The specified arrival time is beyond the length of the list currently
-            ex: the first job we get arrives at t=17. We need to insert it at index 17,
-                so we need to build the list up to 17 first. Times 0-16 will have NULL job entries
-        2. There is a job at the specified arrival time
-            Compare the duration of the incumbent job and the presiding one
-                if incumbent is shorter, insert it before presiding job
-                else check the next time slice and check for scenario 2 or 3
-        3. There is no job at the specified arrival time
-            Just put the job there!
-        Once a time slice has been assigned to the job, all the remaining jobs must be added after it,
-        which means the remaining jobs' arrival times need to be updated to account for the incumbent job's placement.
-            Otherwise, job A's duration 4 slice will be put before its duration 5 slice and that's not what we want.
-    */
-    char* person_name = to_insert->job->person_name;
-    char* job_name = to_insert->job->job_name;
-    size_t arrival_time = to_insert->job->arrival_time;
-    size_t duration = to_insert->job->duration;
-    size_t num_nodes_to_add = duration;
-
-    node* nodes_to_add[num_nodes_to_add];
-
-    nodes_to_add[0] = to_insert;
-    int i;
-    for(i = 1; i < num_nodes_to_add; i++){
+void run_daemon(options* opts){
+    scheduler_daemon d;
+    memset(&d, 0, sizeof(scheduler_daemon));
+    d.socket_path = opts->serve_path;
+    d.config.policy = opts->policies[0];
+    d.config.num_cpus = opts->cpu_counts[0];
+    d.config.quantum = opts->quanta[0];
+    d.config.weights = NULL;
+    d.config.trace = NULL;
+    d.table = create_job_table();
+    d.jobs = d.table == NULL ? NULL : create_name_map(d.table->strings);
+    d.names = (char*)malloc(2 * ((size_t)UINT16_MAX + 1) * sizeof(char));
+    d.stale_from = SIZE_MAX;
+    if(d.jobs == NULL || d.names == NULL){
+        fprintf(stderr, "ERROR in run_daemon() : Could not allocate space for daemon state\n");
+        exit(EXIT_FAILURE);
+    }
+    d.sch = create_scheduler(d.table, NULL, &d.config, 1);
+    d.scheduled = 1;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    if(strlen(d.socket_path) >= sizeof(address.sun_path)){
+        fprintf(stderr, "ERROR in run_daemon() : Socket path %s is longer than %zu characters\n", d.socket_path, sizeof(address.sun_path) - 1);
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, d.socket_path);
+    d.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(d.listen_fd < 0){
+        fprintf(stderr, "ERROR in run_daemon() : Could not create socket : %s\n", strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+    bind_daemon_socket(&d, &address);
+    d.epoll_fd = epoll_create1(0);
+    struct epoll_event listen_event;
+    listen_event.events = EPOLLIN;
+    listen_event.data.ptr = NULL; //connections have their own struct here, the listening socket doesn't
+    if(listen(d.listen_fd, SOMAXCONN) != 0 || set_nonblocking(d.listen_fd) != 0 || d.epoll_fd < 0
+        || epoll_ctl(d.epoll_fd, EPOLL_CTL_ADD, d.listen_fd, &listen_event) != 0){
+        fprintf(stderr, "ERROR in run_daemon() : Could not listen on %s : %s\n", d.socket_path, strerror(errno));
+        unlink(d.socket_path);
+        exit(EXIT_FAILURE);
+    }
 
-        arrival_time++;
-        duration--;
+    //SIGINT and SIGTERM are blocked except while waiting in epoll, so one can't slip in between checking
+    // daemon_stopping and starting to wait
+    struct sigaction action;
+    memset(&action, 0, sizeof(struct sigaction));
+    action.sa_handler = stop_daemon;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigset_t stop_signals;
+    sigset_t wait_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    sigprocmask(SIG_BLOCK, &stop_signals, &wait_mask);
+    sigdelset(&wait_mask, SIGINT);
+    sigdelset(&wait_mask, SIGTERM);
 
-        job* job_to_add = create_job(person_name, job_name, arrival_time, duration);
-        if(job_to_add == NULL){
-            fprintf(stderr, "ERROR in add_node_to_list() : Could not create job\n");
+    fprintf(stdout, "Listening on %s\n", d.socket_path);
+    fflush(stdout);
+
+    struct epoll_event events[DAEMON_MAX_EVENTS];
+    while(!daemon_stopping){
+        //While queries are waiting on the scheduler it only checks for requests in between bursts of scheduling
+        int num_events = epoll_pwait(d.epoll_fd, events, DAEMON_MAX_EVENTS, d.num_waiting > 0 ? 0 : -1, &wait_mask);
+        if(num_events < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            fprintf(stderr, "ERROR in run_daemon() : epoll_pwait() failed : %s\n", strerror(errno));
             exit(EXIT_FAILURE);
         }
-        node* node_to_add = create_node(job_to_add);
-        if(node_to_add == NULL){
-            fprintf(stderr, "ERROR in add_node_to_list : Could not create node\n");
-            exit(EXIT_FAILURE);
+
+        //Read everything that's ready before answering any of it
+        int i;
+        for(i = 0; i < num_events; i++){
+            daemon_connection* c = (daemon_connection*)events[i].data.ptr;
+            if(c == NULL){
+                accept_connections(&d);
+                continue;
+            }
+            if((events[i].events & EPOLLOUT) && flush_connection(&d, c) != 0){
+                close_connection(&d, c);
+                continue;
+            }
+            if(c->waiting_for != 0){
+                //It isn't being read from, so this can only mean the client has gone
+                if(events[i].events & (EPOLLHUP | EPOLLERR)){
+                    close_connection(&d, c);
+                }
+                continue;
+            }
+            if(events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)){
+                if(read_connection(c) != 0){
+                    close_connection(&d, c);
+                    continue;
+                }
+                c->batched = 1;
+                d.batch[d.num_batched] = c;
+                d.num_batched++;
+            }else if(c->closing && c->out_length == 0){
+                close_connection(&d, c);
+            }
         }
+        handle_batch(&d);
+        if(d.num_waiting > 0){
+            advance_schedule(&d);
+            handle_batch(&d);
+        }
+    }
 
-        nodes_to_add[i] = node_to_add;
+    while(d.num_connections > 0){
+        close_connection(&d, d.connections[0]);
     }
+    close(d.epoll_fd);
+    close(d.listen_fd);
+    unlink(d.socket_path);
+    destroy_schedule(finish_scheduler(d.sch));
+    free(d.previous_job);
+    free(d.last_job);
+    free(d.connections);
+    free(d.batch);
+    free(d.names);
+    destroy_name_map(d.jobs);
+    destroy_job_table(d.table);
+}
 
-    //We now have an array with all the nodes we need to add to the list
-    // Once one job is added, cycle through the remaining jobs, updating their arrival times
-    // to be greater than the job we just added
-    node* curr_node;
-    for(i = 0; i < num_nodes_to_add; i++){
-        //For each node to add, traverse through the list to the desired location and attempt to add it
-        curr_node = *head_ref;
-        size_t curr_index = 0;
-        size_t desired_index = nodes_to_add[i]->job->arrival_time;
+void run_client(char* socket_path, FILE* stream){
+    //Turn every line into a request up front, keeping the line to print next to its answer
+    string_table* lines = create_string_table();
+    if(lines == NULL){
+        fprintf(stderr, "ERROR in run_client() : Could not allocate space for lines\n");
+        exit(EXIT_FAILURE);
+    }
+    uint32_t* line_offsets = NULL;
+    char* is_submit = NULL;
+    size_t num_requests = 0;
+    size_t requests_capacity = 0;
+    unsigned char* requests = NULL;
+    size_t requests_length = 0;
+    size_t requests_bytes_capacity = 0;
 
-        if(desired_index > get_length_list(curr_node)){
-            //This means we're trying to add a node beyond the end of the list
-            // so we need to build the list up from the last node to that point
+    size_t line_size = INITIAL_BUFFER_SIZE;
+    char* line = (char*)malloc(line_size * sizeof(char));
+    if(line == NULL){
+        fprintf(stderr, "ERROR in run_client() : malloc() failed to allocate space for input line\n");
+        exit(EXIT_FAILURE);
+    }
+    size_t line_number = 0;
+    while(getline(&line, &line_size, stream) != -1){
+        line_number++;
+        line[strcspn(line, "\r\n")] = '\0';
+        uint32_t line_offset = add_string(lines, line);
+        replace_whitespace(line, ',');
+        char* tokens[MAX_COLUMNS];
+        size_t num_tokens = tokenize_line(line, tokens, MAX_COLUMNS);
+        if(num_tokens == 0){
+            continue;
+        }
 
-            //If head is null, list is empty, add idle node to head
-            if(curr_node == NULL){
-                node* idle_node = create_idle_node();
-                if(idle_node == NULL){
-                    fprintf(stderr, "ERROR in add_node_to_list : Could not create idle node (1)\n");
-                    exit(EXIT_FAILURE);
-                }
-                (*head_ref) = idle_node;
-                curr_node = idle_node;
+        unsigned char header[DAEMON_HEADER_SIZE + DAEMON_SUBMIT_SIZE];
+        size_t header_length = DAEMON_HEADER_SIZE;
+        char* names[2] = {NULL, NULL};
+        if(strcmp(tokens[0], "submit") == 0 && (num_tokens == 5 || num_tokens == 6)){
+            header[2] = REQUEST_SUBMIT;
+            uint64_t deadline = DAEMON_NO_DEADLINE;
+            if(num_tokens == 6 && strcmp(tokens[5], NO_DEADLINE_ENTRY) != 0){
+                deadline = strtosizet(tokens[5]);
+            }
+            encode_number(header + DAEMON_HEADER_SIZE, strtosizet(tokens[3]), 8);
+            encode_number(header + DAEMON_HEADER_SIZE + 8, strtosizet(tokens[4]), 8);
+            encode_number(header + DAEMON_HEADER_SIZE + 16, deadline, 8);
+            encode_number(header + DAEMON_HEADER_SIZE + 24, strlen(tokens[1]), 2);
+            header_length += DAEMON_SUBMIT_SIZE;
+            names[0] = tokens[1];
+            names[1] = tokens[2];
+        }else if((strcmp(tokens[0], "job") == 0 || strcmp(tokens[0], "person") == 0) && num_tokens == 2){
+            header[2] = strcmp(tokens[0], "job") == 0 ? REQUEST_JOB : REQUEST_PERSON;
+            names[0] = tokens[1];
+        }else{
+            fprintf(stderr, "ERROR in run_client() : Didn't understand line %zu : Expected \"submit PERSON JOB ARRIVAL DURATION [DEADLINE]\", \"job JOB\" or \"person PERSON\"\n", line_number);
+            exit(EXIT_FAILURE);
+        }
+        size_t length = header_length - 2 + strlen(names[0]) + (names[1] == NULL ? 0 : strlen(names[1]));
+        if(length > UINT16_MAX){
+            fprintf(stderr, "ERROR in run_client() : Line %zu is too long to send\n", line_number);
+            exit(EXIT_FAILURE);
+        }
+        if(num_requests == UINT32_MAX){
+            fprintf(stderr, "ERROR in run_client() : More than %u requests\n", UINT32_MAX);
+            exit(EXIT_FAILURE);
+        }
+        encode_number(header, length, 2);
+        encode_number(header + 3, num_requests, 4); //the tag is just which request it is
+
+        reserve_bytes(&requests, &requests_bytes_capacity, requests_length + length + 2);
+        memcpy(requests + requests_length, header, header_length);
+        requests_length += header_length;
+        size_t k;
+        for(k = 0; k < 2 && names[k] != NULL; k++){
+            memcpy(requests + requests_length, names[k], strlen(names[k]));
+            requests_length += strlen(names[k]);
+        }
+
+        if(num_requests == requests_capacity){
+            requests_capacity = requests_capacity == 0 ? 16 : requests_capacity * 2;
+            line_offsets = (uint32_t*)realloc(line_offsets, requests_capacity * sizeof(uint32_t));
+            is_submit = (char*)realloc(is_submit, requests_capacity * sizeof(char));
+            if(line_offsets == NULL || is_submit == NULL){
+                fprintf(stderr, "ERROR in run_client() : Could not grow request list\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        line_offsets[num_requests] = line_offset;
+        is_submit[num_requests] = header[2] == REQUEST_SUBMIT;
+        num_requests++;
+    }
+    free(line);
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(struct sockaddr_un));
+    address.sun_family = AF_UNIX;
+    if(strlen(socket_path) >= sizeof(address.sun_path)){
+        fprintf(stderr, "ERROR in run_client() : Socket path %s is longer than %zu characters\n", socket_path, sizeof(address.sun_path) - 1);
+        exit(EXIT_FAILURE);
+    }
+    strcpy(address.sun_path, socket_path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(struct sockaddr_un)) != 0 || set_nonblocking(fd) != 0){
+        fprintf(stderr, "ERROR in run_client() : Could not connect to %s : %s\n", socket_path, strerror(errno));
+        exit(EXIT_FAILURE);
+    }
+
+    //Send and read at the same time. The daemon stops reading from a client that isn't reading its answers
+    size_t sent = 0;
+    size_t num_answered = 0;
+    unsigned char responses[DAEMON_RESPONSE_SIZE * 1024];
+    size_t responses_length = 0;
+    while(num_answered < num_requests){
+        struct pollfd poll_fd;
+        poll_fd.fd = fd;
+        poll_fd.events = POLLIN | (sent < requests_length ? POLLOUT : 0);
+        if(poll(&poll_fd, 1, -1) < 0){
+            if(errno == EINTR){
+                continue;
             }
+            fprintf(stderr, "ERROR in run_client() : poll() failed : %s\n", strerror(errno));
+            exit(EXIT_FAILURE);
+        }
 
-            while(curr_node->next != NULL){
-                curr_node = curr_node->next;
-                curr_index++;
+        if(poll_fd.revents & POLLOUT){
+            ssize_t n = send(fd, requests + sent, requests_length - sent, MSG_NOSIGNAL);
+            if(n > 0){
+                sent += (size_t)n;
+            }else if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+                fprintf(stderr, "ERROR in run_client() : Could not send to %s : %s\n", socket_path, strerror(errno));
+                exit(EXIT_FAILURE);
             }
-            //curr_node now points to the last node in the list
-            while((curr_index + 1) < desired_index){
-                node* idle_node = create_idle_node();
-                if(idle_node == NULL){
-                    fprintf(stderr, "ERROR in add_node_to_list : Could not create idle node (2)\n");
+        }
+        if(poll_fd.revents & (POLLIN | POLLHUP | POLLERR)){
+            ssize_t n = recv(fd, responses + responses_length, sizeof(responses) - responses_length, 0);
+            if(n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)){
+                fprintf(stderr, "ERROR in run_client() : The daemon at %s closed the connection after %zu of %zu answers\n", socket_path, num_answered, num_requests);
+                exit(EXIT_FAILURE);
+            }
+            if(n > 0){
+                responses_length += (size_t)n;
+            }
+
+            size_t position = 0;
+            while(responses_length - position >= DAEMON_RESPONSE_SIZE){
+                unsigned char* response = responses + position;
+                daemon_status status = (daemon_status)response[0];
+                uint32_t tag = (uint32_t)decode_number(response + 1, 4);
+                if(tag != num_answered || status > STATUS_FULL){
+                    fprintf(stderr, "ERROR in run_client() : Got a response the daemon shouldn't have sent\n");
                     exit(EXIT_FAILURE);
                 }
-                curr_node->next = idle_node;
-                curr_node = curr_node->next;
-                curr_index++;
-            }
-        }
-        //At this point the list is long enough to add the item to the list
-        // so let's move curr_node so that curr_node->next is where we want to add the node
-        curr_node = *head_ref;
-        curr_index = 0;
-
-        //special case: head->next is null
-        // !! I'm not sure these are actual cases, since the point of putting idle nodes in makes this impossible(?) !!
-        if(curr_node == NULL){
-            //List is empty (head points to null)
-            // so just add nodes_to_add[i]
-            (*head_ref)->next = nodes_to_add[i];
-        }else if(curr_node->next == NULL){
-            //There's nothing at the place where we want to add the node, just add it
-            curr_node->next = nodes_to_add[i];
-        }else{
-            //The curr_index + 1 is because we want curr_index->next to point to the desired location,
-            // not curr_index itself.
-            while((curr_index + 1) < desired_index){
-                curr_node = curr_node->next;
-                curr_index++;
-            }
-            //Now we're at the place where we want to add the node
-            // is it NULL? If not, is there an idle job or a normal job?
-            if(curr_node->next == NULL){
-                curr_node->next = nodes_to_add[i];
-            }else{
-                if(is_job_idle(curr_node->next->job)){
-                    //Replace idle node with nodes_to_add[i]
-                    node* temp = curr_node->next->next;
-                    nodes_to_add[i]->next = temp;
-                    curr_node->next = nodes_to_add[i];
+                char* text = get_string(lines, line_offsets[tag]);
+                if(status == STATUS_OK && !is_submit[tag]){
+                    fprintf(stdout, "%s\t%llu\n", text, (unsigned long long)decode_number(response + 5, 8));
                 }else{
-                    //There is a valid job at the spot where we want to add the node
-                    // so compare durations
-                    size_t incumbent_duration = nodes_to_add[i]->job->duration;
-                    size_t presiding_duration = curr_node->next->job->duration;
-
-                    if(incumbent_duration < presiding_duration){
-                        //New job belongs before presiding job
-                        nodes_to_add[i]->next = curr_node->next;
-                        curr_node->next = nodes_to_add[i];
-
-                        //Now we need to update the arrival times of every job after the one we just entered
-                        curr_node = curr_node->next->next;
-                        while(curr_node != NULL){
-                            curr_node->job->arrival_time = curr_node->job->arrival_time + 1;
-                            curr_node = curr_node->next;
-                        }
-
-                        //Done inserting node!
-                    }else{
-                        //Presiding job belongs before new job, find new place for incumbent job
-                        // Search for the first available idle space, the first job that's longer than it, or the end of the list
-                        curr_index = 0;
-                        int found_spot = 0;
-                        while(found_spot == 0){
-                            if(curr_node->next == NULL){
-                                //Add node to end of list
-                                curr_node->next = nodes_to_add[i];
-                                found_spot = 1;
-                            }else if(is_job_idle(curr_node->next->job)){
-                                //Replace first found idle spot
-                                node* temp = curr_node->next->next;
-                                nodes_to_add[i]->next = temp;
-                                curr_node->next = nodes_to_add[i];
-                                found_spot = 1;
-                            }else if(curr_node->next->job->duration > incumbent_duration){
-                                //node belongs before curr_node->next
-                                nodes_to_add[i]->next = curr_node->next;
-                                curr_node->next = nodes_to_add[i];
-
-                                //Now we need to update the arrival times of every job after the one we just entered
-                                curr_node = curr_node->next->next;
-                                while(curr_node != NULL){
-                                    curr_node->job->arrival_time = curr_node->job->arrival_time + 1;
-                                    curr_node = curr_node->next;
-                                }
-
-                                found_spot = 1;
-                            }
-                            curr_node = curr_node->next;
-
-                            if(found_spot){
-                                //Update the arrival_times of the remaining nodes in nodes_to_add to be after the node we just added
-                                size_t index_added_at = get_index_of_node(*head_ref, nodes_to_add[i]);
-                                if(index_added_at == -1){
-                                    //This means the node we're looking for wasn't added, but if(found_spot) means it was added, so something terrible has happened
-                                    fprintf(stderr, "ERROR in add_node_to_list : get_index_of_node returned -1 for an unknown reason. Seriously, there's a check to make sure this never happens.\n");
-                                    exit(EXIT_FAILURE);
-                                }
-                                int j;
-                                for(j = 0; j < num_nodes_to_add; j++){
-                                    nodes_to_add[j]->job->arrival_time = index_added_at + (j);
-                                }
-                            }
-                        }
-                    }
+                    fprintf(stdout, "%s\t%s\n", text, status_descriptions[status]);
                 }
+                num_answered++;
+                position += DAEMON_RESPONSE_SIZE;
             }
+            memmove(responses, responses + position, responses_length - position);
+            responses_length -= position;
         }
-
-
     }
-    return 0;
+
+    close(fd);
+    free(requests);
+    free(line_offsets);
+    free(is_submit);
+    destroy_string_table(lines);
 }
 
 //-----------------------FORMATTING IMPLEMENTATION-----------------------//
 
 void replace_whitespace(char* line, char replacement_char){
 
-    //Cycle through string, replace every ' ' or '\t' with replacement_char
-    int i;
-    for(i = 0; i < strlen(line); i++){
-        if(line[i] == ' ' || line[i] == '\t'){
+    //Cycle through string, replace every ' ', '\t' or line ending with replacement_char
+    size_t i;
+    for(i = 0; line[i] != '\0'; i++){
+        if(isspace((unsigned char)line[i])){
             line[i] = replacement_char;
         }
     }
 }
 
+size_t tokenize_line(char* line, char** tokens, size_t max_tokens){
+    char* rest = NULL;
+    size_t num_tokens = 0;
+    char* token = strtok_r(line, ",", &rest);
+    while(token != NULL){
+        if(num_tokens < max_tokens){
+            tokens[num_tokens] = token;
+        }
+        num_tokens++;
+        token = strtok_r(NULL, ",", &rest);
+    }
+    return num_tokens;
+}
+
 //-----------------------CONVERSION IMPLEMENTATION-----------------------//
 
 /**